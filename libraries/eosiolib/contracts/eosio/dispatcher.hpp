@@ -89,6 +89,7 @@ namespace eosio {
       if ( max_stack_buffer_size < size ) {
          free(buffer);
       }
+      internal_use_do_not_use::flush_print_buffer();
       return true;
    }
 
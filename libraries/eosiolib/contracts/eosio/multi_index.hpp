@@ -8,10 +8,10 @@
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/serialize.hpp"
 #include "../../core/eosio/fixed_bytes.hpp"
+#include "../../core/eosio/read_buffer.hpp"
 
 #include <vector>
 #include <tuple>
-#include <boost/hana.hpp>
 #include <functional>
 #include <utility>
 #include <type_traits>
@@ -207,6 +207,20 @@ namespace eosio {
 
 constexpr static inline name same_payer{};
 
+/**
+ *  Tag type of `auto_increment`
+ *
+ *  @ingroup multiindex
+ */
+struct auto_increment_t {};
+
+/**
+ *  Passed to the constructor of a multi_index to persist the next available primary key of the table
+ *
+ *  @ingroup multiindex
+ */
+constexpr static inline auto_increment_t auto_increment{};
+
 template<class Class,typename Type,Type (Class::*PtrToMemberFunction)()const>
 struct const_mem_fun
 {
@@ -270,22 +284,34 @@ struct secondary_index_db_functions<TYPE> {\
    static void    db_idx_remove( int32_t iterator )                           { internal_use_do_not_use::db_##IDX##_remove( iterator ); } \
    static int32_t db_idx_end( uint64_t code, uint64_t scope, uint64_t table ) { return internal_use_do_not_use::db_##IDX##_end( code, scope, table ); } \
    static int32_t db_idx_store( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const TYPE& secondary ) {\
-     return internal_use_do_not_use::db_##IDX##_store( scope, table, payer, id, secondary.data(), TYPE::num_words() ); \
+     auto words = secondary.get_array(); \
+     return internal_use_do_not_use::db_##IDX##_store( scope, table, payer, id, words.data(), TYPE::num_words() ); \
    }\
    static void    db_idx_update( int32_t iterator, uint64_t payer, const TYPE& secondary ) {\
-     internal_use_do_not_use::db_##IDX##_update( iterator, payer, secondary.data(), TYPE::num_words() ); \
+     auto words = secondary.get_array(); \
+     internal_use_do_not_use::db_##IDX##_update( iterator, payer, words.data(), TYPE::num_words() ); \
    }\
    static int32_t db_idx_find_primary( uint64_t code, uint64_t scope, uint64_t table, uint64_t primary, TYPE& secondary ) {\
-     return internal_use_do_not_use::db_##IDX##_find_primary( code, scope, table, secondary.data(), TYPE::num_words(), primary ); \
+     auto words = secondary.get_array(); \
+     auto itr = internal_use_do_not_use::db_##IDX##_find_primary( code, scope, table, words.data(), TYPE::num_words(), primary ); \
+     secondary = TYPE( words ); \
+     return itr; \
    }\
    static int32_t db_idx_find_secondary( uint64_t code, uint64_t scope, uint64_t table, const TYPE& secondary, uint64_t& primary ) {\
-     return internal_use_do_not_use::db_##IDX##_find_secondary( code, scope, table, secondary.data(), TYPE::num_words(), &primary ); \
+     auto words = secondary.get_array(); \
+     return internal_use_do_not_use::db_##IDX##_find_secondary( code, scope, table, words.data(), TYPE::num_words(), &primary ); \
    }\
    static int32_t db_idx_lowerbound( uint64_t code, uint64_t scope, uint64_t table, TYPE& secondary, uint64_t& primary ) {\
-     return internal_use_do_not_use::db_##IDX##_lowerbound( code, scope, table, secondary.data(), TYPE::num_words(), &primary ); \
+     auto words = secondary.get_array(); \
+     auto itr = internal_use_do_not_use::db_##IDX##_lowerbound( code, scope, table, words.data(), TYPE::num_words(), &primary ); \
+     secondary = TYPE( words ); \
+     return itr; \
    }\
    static int32_t db_idx_upperbound( uint64_t code, uint64_t scope, uint64_t table, TYPE& secondary, uint64_t& primary ) {\
-     return internal_use_do_not_use::db_##IDX##_upperbound( code, scope, table, secondary.data(), TYPE::num_words(), &primary ); \
+     auto words = secondary.get_array(); \
+     auto itr = internal_use_do_not_use::db_##IDX##_upperbound( code, scope, table, words.data(), TYPE::num_words(), &primary ); \
+     secondary = TYPE( words ); \
+     return itr; \
    }\
 };
 
@@ -298,8 +324,6 @@ struct secondary_key_traits<TYPE> {\
 
 namespace _multi_index_detail {
 
-   namespace hana = boost::hana;
-
    template<typename T>
    struct secondary_index_db_functions;
 
@@ -330,6 +354,20 @@ namespace _multi_index_detail {
       static constexpr eosio::fixed_bytes<32> true_lowest() { return eosio::fixed_bytes<32>(); }
    };
 
+   /**
+    * Reads the row at primary iterator `itr` into a buffer shared by all the tables of a contract, so that a row
+    * which fits is read with a single db_get_i64 call instead of asking for its size first. The stream is valid
+    * until the next row is read.
+    */
+   inline datastream<const char*> read_row( int32_t itr ) {
+      static internal_use_do_not_use::read_buffer buffer;
+      int size = buffer.read( [itr]( char* data, size_t size ) {
+         return internal_use_do_not_use::db_get_i64( itr, data, uint32_t(size) );
+      });
+      eosio::check( size >= 0, "error reading iterator" );
+      return { buffer.data(), size_t(size) };
+   }
+
 }
 
 /**
@@ -448,6 +486,14 @@ class multi_index
 
       mutable uint64_t _next_primary_key;
 
+      // in auto-increment mode the next primary key is stored in a row of this table, with the table name as
+      // primary key, in the same scope. The name has 13 characters, which `validate_table_name` rejects, so no
+      // multi_index or singleton of the contract can share its rows
+      constexpr static uint64_t next_primary_key_table = eosio::name("autoincr.key1").value;
+
+      bool            _auto_increment = false;
+      mutable int32_t _next_primary_key_itr = -1;
+
       enum next_primary_key_tags : uint64_t {
          no_available_primary_key = static_cast<uint64_t>(-2), // Must be the smallest uint64_t value compared to all other tags
          unset_next_primary_key = static_cast<uint64_t>(-1)
@@ -609,6 +655,127 @@ class multi_index
             const_reverse_iterator crend()const   { return std::make_reverse_iterator(cbegin()); }
             const_reverse_iterator rend()const    { return crend(); }
 
+            // Iterator over the (secondary key, primary key) pairs of the index, in index order. It only uses the
+            // db_idx intrinsics: the objects are never read, and the secondary key is only looked up when it is
+            // needed and wasn't returned by the intrinsic which positioned the iterator.
+            struct key_iterator : public std::iterator<std::bidirectional_iterator_tag, std::pair<secondary_key_type, uint64_t>,
+                                                       std::ptrdiff_t, void, std::pair<secondary_key_type, uint64_t>> {
+               public:
+                  friend bool operator == ( const key_iterator& a, const key_iterator& b ) {
+                     return a._itr == b._itr;
+                  }
+                  friend bool operator != ( const key_iterator& a, const key_iterator& b ) {
+                     return a._itr != b._itr;
+                  }
+
+                  // returned by value so that std::reverse_iterator can be used
+                  std::pair<secondary_key_type, uint64_t> operator*()const {
+                     return {secondary_key(), _primary};
+                  }
+
+                  uint64_t primary_key()const {
+                     eosio::check( _itr >= 0, "cannot dereference end iterator" );
+                     return _primary;
+                  }
+
+                  const secondary_key_type& secondary_key()const {
+                     using namespace _multi_index_detail;
+
+                     eosio::check( _itr >= 0, "cannot dereference end iterator" );
+                     if( !_has_secondary ) {
+                        secondary_index_db_functions<secondary_key_type>::db_idx_find_primary( _idx->get_code().value, _idx->get_scope(), _idx->name(), _primary, _secondary );
+                        _has_secondary = true;
+                     }
+                     return _secondary;
+                  }
+
+                  key_iterator operator++(int) {
+                     key_iterator result(*this);
+                     ++(*this);
+                     return result;
+                  }
+
+                  key_iterator operator--(int) {
+                     key_iterator result(*this);
+                     --(*this);
+                     return result;
+                  }
+
+                  key_iterator& operator++() {
+                     using namespace _multi_index_detail;
+
+                     eosio::check( _itr >= 0, "cannot increment end iterator" );
+                     _itr = secondary_index_db_functions<secondary_key_type>::db_idx_next( _itr, &_primary );
+                     if( _itr < 0 )
+                        _itr = -1;
+                     _has_secondary = false;
+                     return *this;
+                  }
+
+                  key_iterator& operator--() {
+                     using namespace _multi_index_detail;
+
+                     if( _itr < 0 ) {
+                        auto ei = secondary_index_db_functions<secondary_key_type>::db_idx_end( _idx->get_code().value, _idx->get_scope(), _idx->name() );
+                        eosio::check( ei != -1, "cannot decrement end iterator when the index is empty" );
+                        _itr = secondary_index_db_functions<secondary_key_type>::db_idx_previous( ei, &_primary );
+                        eosio::check( _itr >= 0, "cannot decrement end iterator when the index is empty" );
+                     } else {
+                        _itr = secondary_index_db_functions<secondary_key_type>::db_idx_previous( _itr, &_primary );
+                        eosio::check( _itr >= 0, "cannot decrement iterator at beginning of index" );
+                     }
+                     _has_secondary = false;
+                     return *this;
+                  }
+
+                  key_iterator():_idx(nullptr){}
+               private:
+                  friend struct index;
+                  key_iterator( const index* idx, int32_t itr = -1 )
+                  : _idx(idx), _itr(itr < 0 ? -1 : itr) {}
+
+                  const index*               _idx;
+                  int32_t                    _itr           = -1;
+                  uint64_t                   _primary       = 0;
+                  mutable secondary_key_type _secondary     = {};
+                  mutable bool               _has_secondary = false;
+            }; /// struct multi_index::index::key_iterator
+
+            typedef std::reverse_iterator<key_iterator> key_reverse_iterator;
+
+            key_iterator keys_begin()const {
+               using namespace _multi_index_detail;
+               return keys_lower_bound( secondary_key_traits<secondary_key_type>::true_lowest() );
+            }
+            key_iterator keys_end()const   { return key_iterator( this ); }
+
+            key_reverse_iterator keys_rbegin()const { return std::make_reverse_iterator(keys_end()); }
+            key_reverse_iterator keys_rend()const   { return std::make_reverse_iterator(keys_begin()); }
+
+            key_iterator keys_lower_bound( const secondary_key_type& secondary )const {
+               using namespace _multi_index_detail;
+
+               key_iterator result( this );
+               result._secondary = secondary;
+               result._itr = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), result._secondary, result._primary );
+               if( result._itr < 0 )
+                  return keys_end();
+               result._has_secondary = true;
+               return result;
+            }
+
+            key_iterator keys_upper_bound( const secondary_key_type& secondary )const {
+               using namespace _multi_index_detail;
+
+               key_iterator result( this );
+               result._secondary = secondary;
+               result._itr = secondary_index_db_functions<secondary_key_type>::db_idx_upperbound( get_code().value, get_scope(), name(), result._secondary, result._primary );
+               if( result._itr < 0 )
+                  return keys_end();
+               result._has_secondary = true;
+               return result;
+            }
+
             const_iterator find( secondary_key_type&& secondary )const {
                return find( secondary );
             }
@@ -715,6 +882,68 @@ class multi_index
                return itr;
             }
 
+            // Calls `visitor` with each object whose secondary key is in [lower, upper), in index order, stopping
+            // early if it returns false. Objects which aren't loaded are unpacked into a temporary which is only
+            // valid during the call, so the multi_index doesn't grow.
+            template<typename Visitor>
+            void for_each_range( const secondary_key_type& lower, const secondary_key_type& upper, Visitor&& visitor )const {
+               using namespace _multi_index_detail;
+
+               if( !(lower < upper) )
+                  return;
+
+               uint64_t primary = 0;
+               secondary_key_type secondary_copy(upper);
+               auto stop = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), secondary_copy, primary );
+               secondary_copy = lower;
+               auto itr = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), secondary_copy, primary );
+
+               T temp;
+               while( itr >= 0 && itr != stop ) {
+                  uint64_t next_primary = 0;
+                  auto next_itr = secondary_index_db_functions<secondary_key_type>::db_idx_next( itr, &next_primary );
+
+                  auto pitr = internal_use_do_not_use::db_find_i64( get_code().value, get_scope(), table_name, primary );
+                  eosio::check( pitr >= 0, "secondary index refers to a missing object" );
+                  if( !_multidx->visit_row( pitr, temp, visitor ) )
+                     return;
+
+                  itr     = next_itr;
+                  primary = next_primary;
+               }
+            }
+
+            // Erases up to `limit` objects whose secondary key is in [lower, upper) and returns how many were
+            // erased. The objects are not read, iterators to them are invalidated.
+            uint64_t erase_range( const secondary_key_type& lower, const secondary_key_type& upper,
+                                  uint64_t limit = std::numeric_limits<uint64_t>::max() ) {
+               using namespace _multi_index_detail;
+
+               eosio::check( get_code() == current_receiver(), "cannot erase objects in table of another contract" );
+               if( !(lower < upper) )
+                  return 0;
+
+               uint64_t primary = 0;
+               secondary_key_type secondary_copy(upper);
+               auto stop = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), secondary_copy, primary );
+               secondary_copy = lower;
+               auto itr = secondary_index_db_functions<secondary_key_type>::db_idx_lowerbound( get_code().value, get_scope(), name(), secondary_copy, primary );
+
+               uint64_t erased = 0;
+               for( ; itr >= 0 && itr != stop && erased < limit; ++erased ) {
+                  uint64_t next_primary = 0;
+                  auto next_itr = secondary_index_db_functions<secondary_key_type>::db_idx_next( itr, &next_primary );
+
+                  auto pitr = internal_use_do_not_use::db_find_i64( get_code().value, get_scope(), table_name, primary );
+                  eosio::check( pitr >= 0, "secondary index refers to a missing object" );
+                  _multidx->remove_row( pitr, primary, Number, itr );
+
+                  itr     = next_itr;
+                  primary = next_primary;
+               }
+               return erased;
+            }
+
             eosio::name get_code()const  { return _multidx->get_code(); }
             uint64_t    get_scope()const { return _multidx->get_scope(); }
 
@@ -729,34 +958,37 @@ class multi_index
             typename std::conditional<IsConst, const multi_index*, multi_index*>::type _multidx;
       }; /// struct multi_index::index
 
-      template<uint64_t I>
-      struct intc { enum e{ value = I }; operator uint64_t()const{ return I; }  };
+      template<size_t N>
+      using index_definition = std::tuple_element_t<N, std::tuple<Indices...>>;
 
-      static constexpr auto transform_indices( ) {
-         using namespace _multi_index_detail;
+      template<size_t N, bool IsConst = false>
+      using index_at = index<eosio::name::raw(static_cast<uint64_t>(index_definition<N>::index_name)),
+                             typename index_definition<N>::secondary_extractor_type, N, IsConst>;
 
-         typedef decltype( hana::zip_shortest(
-                             hana::make_tuple( intc<0>(), intc<1>(), intc<2>(), intc<3>(), intc<4>(), intc<5>(),
-                                               intc<6>(), intc<7>(), intc<8>(), intc<9>(), intc<10>(), intc<11>(),
-                                               intc<12>(), intc<13>(), intc<14>(), intc<15>() ),
-                             hana::tuple<Indices...>() ) ) indices_input_type;
-
-         return hana::transform( indices_input_type(), [&]( auto&& idx ){
-             typedef typename std::decay<decltype(hana::at_c<0>(idx))>::type num_type;
-             typedef typename std::decay<decltype(hana::at_c<1>(idx))>::type idx_type;
-             return hana::make_tuple( hana::type_c<index<eosio::name::raw(static_cast<uint64_t>(idx_type::index_name)),
-                                                         typename idx_type::secondary_extractor_type,
-                                                         num_type::e::value, false> >,
-                                      hana::type_c<index<eosio::name::raw(static_cast<uint64_t>(idx_type::index_name)),
-                                                         typename idx_type::secondary_extractor_type,
-                                                         num_type::e::value, true> > );
+      template<typename Index>
+      struct index_tag { typedef Index type; };
 
-         });
+      // Calls `f` with an `index_tag` of each secondary index, as a fold expression so that the calls are expanded
+      // in place, one per index
+      template<typename F, size_t... N>
+      static void for_each_index( F&& f, std::index_sequence<N...> ) {
+         ( f( index_tag<index_at<N>>() ), ... );
       }
 
-      typedef decltype( multi_index::transform_indices() ) indices_type;
+      template<typename F>
+      static void for_each_index( F&& f ) {
+         for_each_index( f, std::make_index_sequence<sizeof...(Indices)>() );
+      }
 
-      indices_type _indices;
+      template<name::raw IndexName>
+      static constexpr size_t index_number_of() {
+         constexpr uint64_t names[] = { static_cast<uint64_t>(Indices::index_name)..., 0 };
+         for( size_t i = 0; i < sizeof...(Indices); ++i ) {
+            if( names[i] == static_cast<uint64_t>(IndexName) )
+               return i;
+         }
+         return sizeof...(Indices);
+      }
 
       const item& load_object_by_primary_iterator( int32_t itr )const {
          using namespace _multi_index_detail;
@@ -767,23 +999,15 @@ class multi_index
          if( itr2 != _items_vector.rend() )
             return *itr2->_item;
 
-         auto size = internal_use_do_not_use::db_get_i64( itr, nullptr, 0 );
-         eosio::check( size >= 0, "error reading iterator" );
-
-         //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
-         void* buffer = max_stack_buffer_size < size_t(size) ? malloc(size_t(size)) : alloca(size_t(size));
-
-         internal_use_do_not_use::db_get_i64( itr, buffer, uint32_t(size) );
-
-         datastream<const char*> ds( (char*)buffer, uint32_t(size) );
+         auto ds = read_row( itr );
 
          auto itm = std::make_unique<item>( this, [&]( auto& i ) {
             T& val = static_cast<T&>(i);
             ds >> val;
 
             i.__primary_itr = itr;
-            hana::for_each( _indices, [&]( auto& idx ) {
-               typedef typename decltype(+hana::at_c<1>(idx))::type index_type;
+            for_each_index( [&]( auto idx ) {
+               typedef typename decltype(idx)::type index_type;
 
                i.__iters[ index_type::number() ] = -1;
             });
@@ -795,13 +1019,58 @@ class multi_index
 
          _items_vector.emplace_back( std::move(itm), pk, pitr );
 
-         if ( max_stack_buffer_size < size_t(size) ) {
-            free(buffer);
-         }
-
          return *ptr;
       } /// load_object_by_primary_iterator
 
+      // Calls `visitor` with the object at primary iterator `itr`, unpacking it into `temp` unless it is loaded,
+      // and returns false if the visitor asked to stop
+      template<typename Visitor>
+      bool visit_row( int32_t itr, T& temp, Visitor&& visitor )const {
+         auto cached = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
+            return ptr._primary_itr == itr;
+         });
+         const T* obj = &temp;
+         if( cached != _items_vector.rend() ) {
+            obj = cached->_item.get();
+         } else {
+            auto ds = _multi_index_detail::read_row( itr );
+            ds >> temp;
+         }
+
+         if constexpr( std::is_same<decltype(visitor(*obj)), bool>::value ) {
+            return visitor(*obj);
+         } else {
+            visitor(*obj);
+            return true;
+         }
+      }
+
+      // Removes the object at primary iterator `itr` and its secondary keys without reading it, the iterator of
+      // the secondary key of index number `index_number` is `index_itr` if it is known
+      void remove_row( int32_t itr, uint64_t pk, uint64_t index_number = sizeof...(Indices), int32_t index_itr = -1 ) {
+         using namespace _multi_index_detail;
+
+         auto cached = std::find_if(_items_vector.rbegin(), _items_vector.rend(), [&](const item_ptr& ptr) {
+            return ptr._primary_itr == itr;
+         });
+         if( cached != _items_vector.rend() )
+            _items_vector.erase(--(cached.base()));
+
+         internal_use_do_not_use::db_remove_i64( itr );
+
+         for_each_index( [&]( auto idx ) {
+            typedef typename decltype(idx)::type index_type;
+
+            auto i = index_type::number() == index_number ? index_itr : -1;
+            if( i < 0 ) {
+              typename index_type::secondary_key_type secondary;
+              i = secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_find_primary( _code.value, _scope, index_type::name(), pk,  secondary );
+            }
+            if( i >= 0 )
+               secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_remove( i );
+         });
+      }
+
    public:
       /**
        *  Constructs an instance of a Multi-Index table.
@@ -854,6 +1123,43 @@ class multi_index
       :_code(code),_scope(scope),_next_primary_key(unset_next_primary_key)
       {}
 
+      /**
+       *  Constructs an instance of a Multi-Index table in auto-increment mode.
+       *  @ingroup multiindex
+       *
+       *  The next available primary key is kept in a row of the `autoincr.key1` table in the same scope, which `emplace`
+       *  updates when it adds an object with a primary key at least as large. `available_primary_key` then reads
+       *  that row and checks no object is past it, instead of loading the last object of the table. A table which was
+       *  used without auto-increment mode before is probed once, like without the mode, and the row is created by
+       *  the next `emplace`.
+       *
+       *  The row is an extra object in RAM, billed to the payer of the `emplace` which creates it, and every
+       *  `emplace` which advances the key updates it with a separate write. Objects added by instances without the
+       *  mode leave the row behind; it is then repaired from the largest primary key when it is loaded, so the keys
+       *  returned never collide with existing objects.
+       *
+       *  Table names have at most 12 characters, so the 13 characters of `autoincr.key1` keep it apart from the
+       *  tables of the contract.
+       *
+       *  Unlike without the mode, primary keys are never reused, even after erasing the objects with the largest
+       *  primary keys, as long as the row is not behind.
+       *
+       *  @param code - Account that owns table
+       *  @param scope - Scope identifier within the code hierarchy
+       *
+       *  Example:
+       *
+       *  @code
+       *  orders_table orders( get_self(), get_self().value, eosio::auto_increment );
+       *  orders.emplace( payer, [&]( auto& o ) {
+       *     o.id = orders.available_primary_key();
+       *  });
+       *  @endcode
+       */
+      multi_index( name code, uint64_t scope, auto_increment_t )
+      :_code(code),_scope(scope),_next_primary_key(unset_next_primary_key),_auto_increment(true)
+      {}
+
       /**
        *  Returns the `code` member property.
        *  @ingroup multiindex
@@ -1321,8 +1627,33 @@ class multi_index
        *  @endcode
        */
       uint64_t available_primary_key()const {
+         load_next_primary_key();
+
+         eosio::check( _next_primary_key < no_available_primary_key, "next primary key in table is at autoincrement limit");
+         return _next_primary_key;
+      }
+
+   private:
+      void load_next_primary_key()const {
+         if( _next_primary_key == unset_next_primary_key && _auto_increment ) {
+            _next_primary_key_itr = internal_use_do_not_use::db_find_i64( _code.value, _scope, next_primary_key_table, static_cast<uint64_t>(TableName) );
+            if( _next_primary_key_itr >= 0 ) {
+               uint64_t next = 0;
+               internal_use_do_not_use::db_get_i64( _next_primary_key_itr, &next, sizeof(next) );
+
+               // The row is stale if an instance without auto-increment mode added objects past it, then the key
+               // is repaired from the largest primary key and stored by the next `emplace`
+               if( internal_use_do_not_use::db_lowerbound_i64( _code.value, _scope, static_cast<uint64_t>(TableName), next ) >= 0 ) {
+                  uint64_t last_pk = 0;
+                  internal_use_do_not_use::db_previous_i64( internal_use_do_not_use::db_end_i64( _code.value, _scope, static_cast<uint64_t>(TableName) ), &last_pk );
+                  next = (last_pk >= no_available_primary_key) ? no_available_primary_key : (last_pk + 1);
+               }
+
+               _next_primary_key = next;
+            }
+         }
          if( _next_primary_key == unset_next_primary_key ) {
-            // This is the first time available_primary_key() is called for this multi_index instance.
+            // This is the first time the next primary key is needed for this multi_index instance.
             if( begin() == end() ) { // empty table
                _next_primary_key = 0;
             } else {
@@ -1334,11 +1665,17 @@ class multi_index
                   _next_primary_key = pk + 1;
             }
          }
+      }
 
-         eosio::check( _next_primary_key < no_available_primary_key, "next primary key in table is at autoincrement limit");
-         return _next_primary_key;
+      void store_next_primary_key( name payer ) {
+         if( _next_primary_key_itr >= 0 )
+            internal_use_do_not_use::db_update_i64( _next_primary_key_itr, same_payer.value, &_next_primary_key, sizeof(_next_primary_key) );
+         else
+            _next_primary_key_itr = internal_use_do_not_use::db_store_i64( _scope, next_primary_key_table, payer.value, static_cast<uint64_t>(TableName), &_next_primary_key, sizeof(_next_primary_key) );
       }
 
+   public:
+
       /**
        *  Returns an appropriately typed Secondary Index.
        *  @ingroup multiindex
@@ -1382,15 +1719,11 @@ class multi_index
        */
       template<name::raw IndexName>
       auto get_index() {
-         using namespace _multi_index_detail;
-
-         auto res = hana::find_if( _indices, []( auto&& in ) {
-            return std::integral_constant<bool, static_cast<uint64_t>(std::decay<typename decltype(+hana::at_c<0>(in))::type>::type::index_name) == static_cast<uint64_t>(IndexName)>();
-         });
+         constexpr size_t number = index_number_of<IndexName>();
+         static_assert( number < sizeof...(Indices), "name provided is not the name of any secondary index within multi_index" );
 
-         static_assert( res != hana::nothing, "name provided is not the name of any secondary index within multi_index" );
-
-         return typename decltype(+hana::at_c<0>(res.value()))::type(this);
+         if constexpr( number < sizeof...(Indices) )
+            return index_at<number>(this);
       }
 
       /**
@@ -1433,15 +1766,11 @@ class multi_index
        */
       template<name::raw IndexName>
       auto get_index()const {
-         using namespace _multi_index_detail;
-
-         auto res = hana::find_if( _indices, []( auto&& in ) {
-            return std::integral_constant<bool, static_cast<uint64_t>(std::decay<typename decltype(+hana::at_c<1>(in))::type>::type::index_name) == static_cast<uint64_t>(IndexName)>();
-         });
-
-         static_assert( res != hana::nothing, "name provided is not the name of any secondary index within multi_index" );
+         constexpr size_t number = index_number_of<IndexName>();
+         static_assert( number < sizeof...(Indices), "name provided is not the name of any secondary index within multi_index" );
 
-         return typename decltype(+hana::at_c<1>(res.value()))::type(this);
+         if constexpr( number < sizeof...(Indices) )
+            return index_at<number, true>(this);
       }
 
       /**
@@ -1527,6 +1856,9 @@ class multi_index
 
          eosio::check( _code == current_receiver(), "cannot create objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
 
+         if( _auto_increment )
+            load_next_primary_key();
+
          auto itm = std::make_unique<item>( this, [&]( auto& i ){
             T& obj = static_cast<T&>(i);
             constructor( obj );
@@ -1547,11 +1879,14 @@ class multi_index
                free(buffer);
             }
 
-            if( pk >= _next_primary_key )
+            if( pk >= _next_primary_key ) {
                _next_primary_key = (pk >= no_available_primary_key) ? no_available_primary_key : (pk + 1);
+               if( _auto_increment )
+                  store_next_primary_key( payer );
+            }
 
-            hana::for_each( _indices, [&]( auto& idx ) {
-               typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
+            for_each_index( [&]( auto idx ) {
+               typedef typename decltype(idx)::type index_type;
 
                i.__iters[index_type::number()] = secondary_index_db_functions<typename index_type::secondary_key_type>::db_idx_store( _scope, index_type::name(), payer.value, obj.primary_key(), index_type::extract_secondary_key(obj) );
             });
@@ -1663,11 +1998,7 @@ class multi_index
          auto& mutableitem = const_cast<item&>(objitem);
          eosio::check( _code == current_receiver(), "cannot modify objects in table of another contract" ); // Quick fix for mutating db using multi_index that shouldn't allow mutation. Real fix can come in RC2.
 
-         auto secondary_keys = hana::transform( _indices, [&]( auto&& idx ) {
-            typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
-
-            return index_type::extract_secondary_key( obj );
-         });
+         auto secondary_keys = std::make_tuple( typename Indices::secondary_extractor_type()( obj )... );
 
          auto pk = obj.primary_key();
 
@@ -1692,11 +2023,11 @@ class multi_index
          if( pk >= _next_primary_key )
             _next_primary_key = (pk >= no_available_primary_key) ? no_available_primary_key : (pk + 1);
 
-         hana::for_each( _indices, [&]( auto& idx ) {
-            typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
+         for_each_index( [&]( auto idx ) {
+            typedef typename decltype(idx)::type index_type;
 
             auto secondary = index_type::extract_secondary_key( obj );
-            if( memcmp( &hana::at_c<index_type::index_number>(secondary_keys), &secondary, sizeof(secondary) ) != 0 ) {
+            if( memcmp( &std::get<index_type::number()>(secondary_keys), &secondary, sizeof(secondary) ) != 0 ) {
                auto indexitr = mutableitem.__iters[index_type::number()];
 
                if( indexitr < 0 ) {
@@ -1898,8 +2229,8 @@ class multi_index
 
          internal_use_do_not_use::db_remove_i64( objitem.__primary_itr );
 
-         hana::for_each( _indices, [&]( auto& idx ) {
-            typedef typename decltype(+hana::at_c<0>(idx))::type index_type;
+         for_each_index( [&]( auto idx ) {
+            typedef typename decltype(idx)::type index_type;
 
             auto i = objitem.__iters[index_type::number()];
             if( i < 0 ) {
@@ -1911,5 +2242,89 @@ class multi_index
          });
       }
 
+      /**
+       *  Visits the objects with a primary key in [lower, upper) in order, without adding them to the multi_index.
+       *  @ingroup multiindex
+       *
+       *  Objects which aren't loaded yet are unpacked into a temporary object, so the reference passed to the
+       *  visitor is only valid during the call. Unlike iterating with `++itr`, nothing is looked up again by
+       *  primary key.
+       *
+       *  @param lower - Smallest primary key visited
+       *  @param upper - Primary key at which the scan stops, it is not visited
+       *  @param visitor - Called with a `const T&` for each object, the scan stops early if it returns `false`
+       *
+       *  Example:
+       *
+       *  @code
+       *  uint64_t total = 0;
+       *  orders.for_each_range( 100, 200, [&]( const order& o ) { total += o.amount; } );
+       *  @endcode
+       */
+      template<typename Visitor>
+      void for_each_range( uint64_t lower, uint64_t upper, Visitor&& visitor )const {
+         if( lower >= upper )
+            return;
+
+         auto stop = internal_use_do_not_use::db_lowerbound_i64( _code.value, _scope, static_cast<uint64_t>(TableName), upper );
+         auto itr  = internal_use_do_not_use::db_lowerbound_i64( _code.value, _scope, static_cast<uint64_t>(TableName), lower );
+
+         T temp;
+         while( itr >= 0 && itr != stop ) {
+            if( !visit_row( itr, temp, visitor ) )
+               return;
+            uint64_t next_pk;
+            itr = internal_use_do_not_use::db_next_i64( itr, &next_pk );
+         }
+      }
+
+      /**
+       *  Erases up to `limit` objects with a primary key in [lower, upper).
+       *  @ingroup multiindex
+       *
+       *  The table is walked with its raw iterators, objects aren't read (except the first one when the table has
+       *  secondary indices, to learn its primary key) and nothing is added to the multi_index. Iterators and
+       *  references to the erased objects are invalidated.
+       *
+       *  @param lower - Smallest primary key erased
+       *  @param upper - Primary key at which erasing stops, it is not erased
+       *  @param limit - Maximum number of objects erased
+       *  @return uint64_t - Number of objects erased
+       *
+       *  Example:
+       *
+       *  @code
+       *  // expire at most 500 orders per action
+       *  orders.erase_range( 0, current_time_point().sec_since_epoch(), 500 );
+       *  @endcode
+       */
+      uint64_t erase_range( uint64_t lower, uint64_t upper, uint64_t limit = std::numeric_limits<uint64_t>::max() ) {
+         eosio::check( _code == current_receiver(), "cannot erase objects in table of another contract" );
+         if( lower >= upper )
+            return 0;
+
+         auto stop = internal_use_do_not_use::db_lowerbound_i64( _code.value, _scope, static_cast<uint64_t>(TableName), upper );
+         auto itr  = internal_use_do_not_use::db_lowerbound_i64( _code.value, _scope, static_cast<uint64_t>(TableName), lower );
+
+         // only secondary keys need the primary key, db_lowerbound_i64 doesn't return it but db_next_i64 does
+         uint64_t pk = lower;
+         if constexpr( sizeof...(Indices) > 0 ) {
+            if( itr >= 0 && itr != stop ) {
+               T temp;
+               visit_row( itr, temp, [&]( const T& obj ) { pk = obj.primary_key(); } );
+            }
+         }
+
+         uint64_t erased = 0;
+         for( ; itr >= 0 && itr != stop && erased < limit; ++erased ) {
+            uint64_t next_pk = 0;
+            auto next_itr = internal_use_do_not_use::db_next_i64( itr, &next_pk );
+            remove_row( itr, pk );
+            itr = next_itr;
+            pk  = next_pk;
+         }
+         return erased;
+      }
+
 };
 }  /// eosio
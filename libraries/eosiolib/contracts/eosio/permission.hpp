@@ -9,8 +9,11 @@
 #include "../../core/eosio/name.hpp"
 #include "../../core/eosio/time.hpp"
 
-#include <set>
+#include <iterator>
 #include <limits>
+#include <set>
+#include <type_traits>
+#include <vector>
 
 namespace eosio {
    namespace internal_use_do_not_use {
@@ -30,6 +33,34 @@ namespace eosio {
          __attribute__((eosio_wasm_import))
          int64_t get_account_creation_time(uint64_t);
       }
+
+      /// enabled when `Range` stores its elements contiguously as `T`, like an array, a std::vector or a span
+      template<typename Range, typename T>
+      using enable_if_contiguous_range = std::enable_if_t<
+         std::is_convertible<decltype(std::data(std::declval<const Range&>())), const T*>::value, int>;
+
+      /// scratch buffer the authorization checks pack their arguments into, its capacity is kept across calls
+      inline std::vector<char>& authorization_buffer() {
+         static std::vector<char> buffer;
+         return buffer;
+      }
+
+      /// appends `size` elements to `buffer` packed like a std::set of them and returns the packed size
+      template<typename T>
+      uint32_t pack_authorization_range( std::vector<char>& buffer, const T* data, size_t size ) {
+         if( size == 0 )
+            return 0;
+         size_t packed_size = pack_size(unsigned_int(size));
+         for( size_t i = 0; i < size; ++i )
+            packed_size += pack_size(data[i]);
+         auto start = buffer.size();
+         buffer.resize(start + packed_size);
+         datastream<char*> ds(buffer.data() + start, packed_size);
+         ds << unsigned_int(size);
+         for( size_t i = 0; i < size; ++i )
+            ds << data[i];
+         return packed_size;
+      }
    }
 
    /**
@@ -173,6 +204,88 @@ namespace eosio {
       return (res > 0);
    }
 
+   /**
+    *  Checks if a transaction is authorized by a provided list of keys and permissions without allocating them
+    *  as sets, the transaction, keys and permissions are packed into a scratch buffer which is reused by every call
+    *  @ingroup permission
+    *
+    *  @param trx - the transaction for which to check authorizations
+    *  @param provided_permissions - contiguous range of the permissions which have authorized the transaction (empty permission name acts as wildcard), such as an array or a std::vector, sorted and without duplicates like the set it replaces
+    *  @param provided_keys - contiguous range of the public keys which have authorized the transaction, sorted and without duplicates
+    *
+    *  @return whether the transaction was authorized by provided keys and permissions
+    */
+   template<typename Permissions, typename Keys = std::vector<public_key>,
+            internal_use_do_not_use::enable_if_contiguous_range<Permissions, permission_level> = 0,
+            internal_use_do_not_use::enable_if_contiguous_range<Keys, public_key> = 0>
+   bool
+   check_transaction_authorization( const transaction&  trx,
+                                    const Permissions&  provided_permissions,
+                                    const Keys&         provided_keys = Keys()
+                                  )
+   {
+      auto& buffer = internal_use_do_not_use::authorization_buffer();
+      size_t trx_size = pack_size(trx);
+      buffer.resize(trx_size);
+      datastream<char*> ds(buffer.data(), trx_size);
+      ds << trx;
+
+      uint32_t keys_size  = internal_use_do_not_use::pack_authorization_range( buffer, std::data(provided_keys), std::size(provided_keys) );
+      uint32_t perms_size = internal_use_do_not_use::pack_authorization_range( buffer, std::data(provided_permissions), std::size(provided_permissions) );
+
+      // the buffer may have moved while it grew, so the pointers are taken once everything is packed
+      const char* keys_data = buffer.data() + trx_size;
+      auto res = internal_use_do_not_use::check_transaction_authorization( buffer.data(), trx_size,
+                                                    keys_size  ? keys_data              : (const char*)0, keys_size,
+                                                    perms_size ? keys_data + keys_size  : (const char*)0, perms_size
+                                                  );
+
+      return (res > 0);
+   }
+
+   /**
+    *  Checks if a permission is authorized by a provided delay and a provided list of keys and permissions without
+    *  allocating them as sets, the keys and permissions are packed into a scratch buffer which is reused by every call
+    *
+    *  @ingroup permission
+    *
+    *  @param account    - the account owner of the permission
+    *  @param permission - the permission name to check for authorization
+    *  @param provided_keys - contiguous range of the public keys which have authorized the transaction, sorted and without duplicates
+    *  @param provided_permissions - contiguous range of the permissions which have authorized the transaction (empty permission name acts as wildcard), sorted and without duplicates
+    *  @param provided_delay_us - the provided delay in microseconds (cannot exceed INT64_MAX)
+    *
+    *  @return whether the permission was authorized by provided delay, keys, and permissions
+    */
+   template<typename Keys, typename Permissions = std::vector<permission_level>,
+            internal_use_do_not_use::enable_if_contiguous_range<Keys, public_key> = 0,
+            internal_use_do_not_use::enable_if_contiguous_range<Permissions, permission_level> = 0>
+   bool
+   check_permission_authorization( name                account,
+                                   name                permission,
+                                   const Keys&         provided_keys,
+                                   const Permissions&  provided_permissions = Permissions(),
+                                   microseconds        provided_delay = microseconds{std::numeric_limits<int64_t>::max()}
+                                 )
+   {
+      int64_t provided_delay_us = provided_delay.count();
+      check(provided_delay_us >= 0, "negative delay is not allowed");
+      auto& buffer = internal_use_do_not_use::authorization_buffer();
+      buffer.clear();
+
+      uint32_t keys_size  = internal_use_do_not_use::pack_authorization_range( buffer, std::data(provided_keys), std::size(provided_keys) );
+      uint32_t perms_size = internal_use_do_not_use::pack_authorization_range( buffer, std::data(provided_permissions), std::size(provided_permissions) );
+
+      auto res = internal_use_do_not_use::check_permission_authorization( account.value,
+                                                   permission.value,
+                                                   keys_size  ? buffer.data()             : (const char*)0, keys_size,
+                                                   perms_size ? buffer.data() + keys_size : (const char*)0, perms_size,
+                                                   static_cast<uint64_t>(provided_delay_us)
+                                                 );
+
+      return (res > 0);
+   }
+
    /**
     *  Returns the last used time of a permission
     *
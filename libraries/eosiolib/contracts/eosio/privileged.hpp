@@ -284,9 +284,8 @@ namespace eosio {
     * @param feature_digest - digest of the protocol feature to pre-activate
     */
    inline void preactivate_feature( const checksum256& feature_digest ) {
-      auto feature_digest_data = feature_digest.extract_as_byte_array();
       internal_use_do_not_use::preactivate_feature(
-         reinterpret_cast<const internal_use_do_not_use::capi_checksum256*>( feature_digest_data.data() )
+         reinterpret_cast<const internal_use_do_not_use::capi_checksum256*>( feature_digest.bytes() )
       );
    }
 
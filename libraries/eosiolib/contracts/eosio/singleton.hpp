@@ -2,6 +2,8 @@
 #include "multi_index.hpp"
 #include "system.hpp"
 
+#include <optional>
+
 namespace  eosio {
 
    /**
@@ -130,4 +132,199 @@ namespace  eosio {
       private:
          table _t;
    };
+
+   /**
+    *  Singleton which reads its row at most once and writes it back at most once.
+    *
+    *  The value is loaded by the first call that needs it and kept in memory, `set` and `modify` only change
+    *  the cached copy and mark it dirty. The row is written with a single `db_update_i64`, or `db_store_i64` if
+    *  it doesn't exist yet, by `flush` or when the singleton is destroyed, e.g. at the end of the action when it
+    *  is a member of the contract. The row has the same layout as the one of `singleton`, but both shouldn't be
+    *  used on the same table in the same action since neither sees what the other hasn't written yet.
+    *
+    *  @ingroup singleton
+    *  @tparam SingletonName - the name of this singleton variable
+    *  @tparam T - the type of the singleton
+    */
+   template<name::raw SingletonName, typename T>
+   class cached_singleton
+   {
+      /**
+       * Primary key of the data inside singleton table
+       */
+      constexpr static uint64_t pk_value = static_cast<uint64_t>(SingletonName);
+
+      constexpr static size_t max_stack_buffer_size = 512;
+
+      // the same limit as the table names of multi_index, which keeps 13 character names free for eosio's own tables
+      static_assert( name(SingletonName).length() < 13, "cached_singleton does not support names with a length greater than 12" );
+
+      public:
+
+         /**
+          * Construct a new cached singleton object given the table's owner and the scope, nothing is read yet
+          *
+          * @param code - The table's owner
+          * @param scope - The scope of the table
+          */
+         cached_singleton( name code, uint64_t scope ) : _code( code ), _scope( scope ) {}
+
+         cached_singleton( const cached_singleton& ) = delete;
+         cached_singleton& operator=( const cached_singleton& ) = delete;
+
+         /**
+          * Writes the value back if it was changed
+          */
+         ~cached_singleton() {
+            flush();
+         }
+
+         /**
+          *  Check if the singleton table exists, or will once the value is written back
+          *
+          * @return true - if exists
+          * @return false - otherwise
+          */
+         bool exists() {
+            load();
+            return _value.has_value();
+         }
+
+         /**
+          * Get the value stored inside the singleton table. Will throw an exception if it doesn't exist
+          *
+          * @brief Get the value stored inside the singleton table
+          * @return const T& - The cached value, valid until the singleton is removed or destroyed
+          */
+         const T& get() {
+            load();
+            eosio::check( _value.has_value(), "singleton does not exist" );
+            return *_value;
+         }
+
+         /**
+          * Get the value stored inside the singleton table. If it doesn't exist, it will return the specified default value
+          *
+          * @param def - The default value to be returned in case the data doesn't exist
+          * @return T - The value stored
+          */
+         T get_or_default( const T& def = T() ) {
+            load();
+            return _value ? *_value : def;
+         }
+
+         /**
+          * Get the value stored inside the singleton table. If it doesn't exist, it will be set to the specified
+          * default value, which is stored when the singleton is written back
+          *
+          * @param bill_to_account - The account to bill for the newly created data if the data doesn't exist
+          * @param def - The default value to be created in case the data doesn't exist
+          * @return const T& - The cached value
+          */
+         const T& get_or_create( name bill_to_account, const T& def = T() ) {
+            load();
+            if( !_value )
+               set( def, bill_to_account );
+            return *_value;
+         }
+
+         /**
+          * Set new value to the singleton table, it is stored when the singleton is written back
+          *
+          * @param value - New value to be set
+          * @param bill_to_account - Account to pay for the new value
+          */
+         void set( const T& value, name bill_to_account ) {
+            load();
+            mark_dirty( bill_to_account );
+            _value = value;
+         }
+
+         /**
+          * Get the cached value to change it in place, the value must exist
+          *
+          * @param bill_to_account - Account to pay for the new value
+          * @return T& - The cached value, which is stored when the singleton is written back
+          */
+         T& modify( name bill_to_account ) {
+            get();
+            mark_dirty( bill_to_account );
+            return *_value;
+         }
+
+         /**
+          * Remove the only data inside singleton table, this is not deferred
+          */
+         void remove() {
+            load();
+            if( _itr >= 0 ) {
+               eosio::check( _code == current_receiver(), "cannot erase objects in table of another contract" );
+               internal_use_do_not_use::db_remove_i64( _itr );
+               _itr = -1;
+            }
+            _value.reset();
+            _dirty = false;
+         }
+
+         /**
+          * Check if the cached value was changed since it was read or last written back
+          */
+         bool dirty()const {
+            return _dirty;
+         }
+
+         /**
+          * Write the value back if it was changed
+          */
+         void flush() {
+            if( !_dirty )
+               return;
+
+            size_t size = pack_size( *_value );
+            //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
+            void* buffer = max_stack_buffer_size < size ? malloc(size) : alloca(size);
+
+            datastream<char*> ds( (char*)buffer, size );
+            ds << *_value;
+
+            if( _itr >= 0 )
+               internal_use_do_not_use::db_update_i64( _itr, _payer.value, buffer, size );
+            else
+               _itr = internal_use_do_not_use::db_store_i64( _scope, pk_value, _payer.value, pk_value, buffer, size );
+
+            if ( max_stack_buffer_size < size ) {
+               free(buffer);
+            }
+            _dirty = false;
+         }
+
+      private:
+         void load() {
+            if( _loaded )
+               return;
+            _loaded = true;
+
+            _itr = internal_use_do_not_use::db_find_i64( _code.value, _scope, pk_value, pk_value );
+            if( _itr < 0 )
+               return;
+
+            auto ds = _multi_index_detail::read_row( _itr );
+            _value.emplace();
+            ds >> *_value;
+         }
+
+         void mark_dirty( name bill_to_account ) {
+            eosio::check( _code == current_receiver(), "cannot modify objects in table of another contract" );
+            _payer = bill_to_account;
+            _dirty = true;
+         }
+
+         name             _code;
+         uint64_t         _scope;
+         int32_t          _itr    = -1;
+         bool             _loaded = false;
+         bool             _dirty  = false;
+         name             _payer;
+         std::optional<T> _value;
+   };
 } /// namespace eosio
@@ -47,6 +47,7 @@ namespace eosio {
     *  @endcode
     */
    inline void eosio_exit( int32_t code ) {
+     internal_use_do_not_use::flush_print_buffer();
      internal_use_do_not_use::eosio_exit(code);
    }
 
@@ -75,9 +76,8 @@ namespace eosio {
     * @return true if the specified protocol feature has been activated, false otherwise
     */
    inline bool is_feature_activated( const checksum256& feature_digest ) {
-      auto feature_digest_data = feature_digest.extract_as_byte_array();
       return internal_use_do_not_use::is_feature_activated(
-         reinterpret_cast<const internal_use_do_not_use::capi_checksum256*>( feature_digest_data.data() )
+         reinterpret_cast<const internal_use_do_not_use::capi_checksum256*>( feature_digest.bytes() )
       );
    }
 
@@ -7,7 +7,9 @@
 #include "system.hpp"
 #include "../../core/eosio/time.hpp"
 #include "../../core/eosio/serialize.hpp"
+#include "../../core/eosio/read_buffer.hpp"
 
+#include <cstring>
 #include <vector>
 
 namespace eosio {
@@ -134,6 +136,171 @@ namespace eosio {
       EOSLIB_SERIALIZE_DERIVED( transaction, transaction_header, (context_free_actions)(actions)(transaction_extensions) )
    };
 
+   /**
+    *  Class transaction_builder packs a deferred transaction straight into one buffer, action by action,
+    *  instead of building a transaction whose actions each own their packed data and packing it all again.
+    *  The buffer holds the same bytes as packing a transaction with the same header and actions.
+    *
+    *  Context free actions have to be added before the actions.
+    *
+    *  @ingroup transaction
+    *
+    *  Example:
+    *  @code
+    *  transaction_builder trx;
+    *  for( const auto& p : payouts )
+    *     trx.add_action( permission_level{get_self(), "active"_n}, "eosio.token"_n, "transfer"_n, get_self(), p.to, p.quantity, std::string("payout") );
+    *  trx.send( sender_id, get_self() );
+    *  @endcode
+    */
+   class transaction_builder {
+   public:
+
+      /**
+       * Construct a new transaction_builder, the header defaults to an expiration of now + 60 seconds
+       *
+       * @param header - header of the transaction
+       */
+      explicit transaction_builder( const transaction_header& header = transaction_header() ) {
+         append(header);
+         _context_free_slot = reserve_count();
+      }
+
+      /**
+       *  Appends a context free action, which has no authorization
+       *
+       *  @param account - the account the action is intended for
+       *  @param action_name - the name of the action
+       *  @param args - the fields of the action data, packed in place one after the other
+       */
+      template<typename... Args>
+      transaction_builder& add_context_free_action( name account, name action_name, const Args&... args ) {
+         check( _actions_slot == 0, "context free actions must be added before actions" );
+         append_action( account, action_name, nullptr, 0, args... );
+         ++_context_free_count;
+         return *this;
+      }
+
+      /**
+       *  Appends an action authorized by one permission
+       *
+       *  @param auth - the permission that authorizes the action
+       *  @param account - the account the action is intended for
+       *  @param action_name - the name of the action
+       *  @param args - the fields of the action data, packed in place one after the other
+       */
+      template<typename... Args>
+      transaction_builder& add_action( const permission_level& auth, name account, name action_name, const Args&... args ) {
+         return add_authorized_action( &auth, 1, account, action_name, args... );
+      }
+
+      /**
+       *  Appends an action authorized by a list of permissions
+       *
+       *  @param auths - the permissions that authorize the action
+       *  @param account - the account the action is intended for
+       *  @param action_name - the name of the action
+       *  @param args - the fields of the action data, packed in place one after the other
+       */
+      template<typename... Args>
+      transaction_builder& add_action( const std::vector<permission_level>& auths, name account, name action_name, const Args&... args ) {
+         return add_authorized_action( auths.data(), auths.size(), account, action_name, args... );
+      }
+
+      /**
+       *  Sends the packed transaction as a deferred transaction, it can be sent again but no actions can be added anymore
+       *
+       *  @param sender_id - ID of sender
+       *  @param payer - Account paying for RAM
+       *  @param replace_existing - Defaults to false, if this is `0`/false then if the provided sender_id is already in use by an in-flight transaction from this contract, which will be a failing assert. If `1` then transaction will atomically cancel/replace the inflight transaction
+       */
+      void send( const uint128_t& sender_id, name payer, bool replace_existing = false ) {
+         finish();
+         internal_use_do_not_use::send_deferred( sender_id, payer.value, _buffer.data() + _start, _buffer.size() - _start, replace_existing );
+      }
+
+   private:
+      static constexpr size_t max_count_size = 5; // packed size of the largest unsigned_int
+
+      std::vector<char> _buffer;
+      size_t            _context_free_slot  = 0;
+      size_t            _actions_slot       = 0;
+      uint32_t          _context_free_count = 0;
+      uint32_t          _actions_count      = 0;
+      size_t            _start              = 0;
+      bool              _finished           = false;
+
+      datastream<char*> append_stream( size_t size ) {
+         auto pos = _buffer.size();
+         _buffer.resize( pos + size );
+         return datastream<char*>( _buffer.data() + pos, size );
+      }
+
+      template<typename T>
+      void append( const T& value ) {
+         auto ds = append_stream( pack_size(value) );
+         ds << value;
+      }
+
+      // room for the count of a list of actions, which is only known once the transaction is sent
+      size_t reserve_count() {
+         auto pos = _buffer.size();
+         _buffer.resize( pos + max_count_size );
+         return pos;
+      }
+
+      // writes a count right before `end` and returns where it starts
+      size_t write_count_before( size_t end, uint32_t count ) {
+         size_t size = pack_size( unsigned_int(count) );
+         datastream<char*> ds( _buffer.data() + end - size, size );
+         ds << unsigned_int(count);
+         return end - size;
+      }
+
+      template<typename... Args>
+      transaction_builder& add_authorized_action( const permission_level* auths, size_t nauths, name account, name action_name, const Args&... args ) {
+         if( _actions_slot == 0 )
+            _actions_slot = reserve_count();
+         append_action( account, action_name, auths, nauths, args... );
+         ++_actions_count;
+         return *this;
+      }
+
+      template<typename... Args>
+      void append_action( name account, name action_name, const permission_level* auths, size_t nauths, const Args&... args ) {
+         check( !_finished, "cannot add actions to a transaction_builder which was sent" );
+         size_t data_size = (size_t(0) + ... + pack_size(args));
+         size_t size = sizeof(account) + sizeof(action_name) + pack_size( unsigned_int(uint32_t(nauths)) ) + nauths * sizeof(permission_level)
+                     + pack_size( unsigned_int(uint32_t(data_size)) ) + data_size;
+         auto ds = append_stream( size );
+         ds << account << action_name << unsigned_int(uint32_t(nauths));
+         for( size_t i = 0; i < nauths; ++i )
+            ds << auths[i];
+         ds << unsigned_int(uint32_t(data_size));
+         (ds << ... << args);
+      }
+
+      void finish() {
+         if( _finished )
+            return;
+         _finished = true;
+         if( _actions_slot == 0 )
+            _actions_slot = reserve_count();
+         append( unsigned_int(0) ); // transaction_extensions
+
+         // each count is written at the end of its slot and what comes before it is moved up against it,
+         // so only the header and the context free actions are moved, never the actions
+         size_t start = write_count_before( _actions_slot + max_count_size, _actions_count );
+         size_t context_free_size = _actions_slot - (_context_free_slot + max_count_size);
+         start -= context_free_size;
+         memmove( _buffer.data() + start, _buffer.data() + _context_free_slot + max_count_size, context_free_size );
+         start = write_count_before( start, _context_free_count );
+         start -= _context_free_slot;
+         memmove( _buffer.data() + start, _buffer.data(), _context_free_slot );
+         _start = start;
+      }
+   };
+
    /**
     *  Struct onerror contains and sender id and packed transaction
     *
@@ -175,6 +342,156 @@ namespace eosio {
    inline void send_deferred(const uint128_t& sender_id, name payer, const char* serialized_transaction, size_t size, bool replace = false) {
      internal_use_do_not_use::send_deferred(sender_id, payer.value, serialized_transaction, size, replace);
    }
+   /**
+    *  Read only view of a packed action. The account and name are read straight from the packed bytes, the
+    *  authorization and data are only located when they are first asked for and nothing is copied.
+    *
+    *  @ingroup transaction
+    */
+   class action_view {
+   public:
+
+      /**
+       * Construct a view of a packed action, the bytes have to outlive the view
+       *
+       * @param data - pointer to the packed action
+       * @param size - size of the packed action
+       */
+      action_view( const char* data, size_t size )
+         :_data(data), _size(size)
+      {
+         eosio::check( size >= 2*sizeof(uint64_t), "action_view: action is too short" );
+      }
+
+      /**
+       * Name of the account the action is intended for
+       */
+      eosio::name account()const { return eosio::name{ read_uint64(0) }; }
+
+      /**
+       * Name of the action
+       */
+      eosio::name name()const { return eosio::name{ read_uint64(sizeof(uint64_t)) }; }
+
+      /**
+       * Number of permissions that authorize this action
+       */
+      uint32_t authorization_size()const {
+         locate();
+         return _authorization_size;
+      }
+
+      /**
+       * Permission which authorizes this action at position `i`
+       */
+      permission_level authorization( uint32_t i )const {
+         eosio::check( i < authorization_size(), "action_view: authorization index out of range" );
+         size_t offset = _authorization_offset + i * 2*sizeof(uint64_t);
+         return permission_level{ eosio::name{ read_uint64(offset) }, eosio::name{ read_uint64(offset + sizeof(uint64_t)) } };
+      }
+
+      /**
+       * Pointer to the packed payload data
+       */
+      const char* data()const {
+         locate();
+         return _data + _data_offset;
+      }
+
+      /**
+       * Size of the packed payload data
+       */
+      size_t data_size()const {
+         locate();
+         return _data_size;
+      }
+
+      /**
+       * Retrieve the unpacked data as T
+       *
+       * @tparam T expected type of data
+       * @return the action data
+       */
+      template<typename T>
+      T data_as()const {
+         return unpack<T>( data(), data_size() );
+      }
+
+      /**
+       * Unpacks the whole action, copying its authorization and data
+       */
+      action to_action()const {
+         return unpack<action>( _data, _size );
+      }
+
+   private:
+      const char*      _data;
+      size_t           _size;
+      mutable bool     _located = false;
+      mutable uint32_t _authorization_size = 0;
+      mutable size_t   _authorization_offset = 0;
+      mutable size_t   _data_offset = 0;
+      mutable size_t   _data_size = 0;
+
+      uint64_t read_uint64( size_t offset )const {
+         uint64_t value;
+         memcpy( &value, _data + offset, sizeof(value) );
+         return value;
+      }
+
+      void locate()const {
+         if( _located )
+            return;
+         datastream<const char*> ds( _data + 2*sizeof(uint64_t), _size - 2*sizeof(uint64_t) );
+         unsigned_int count;
+         ds >> count;
+         _authorization_size   = count.value;
+         _authorization_offset = ds.pos() - _data;
+         eosio::check( ds.remaining() >= size_t(count.value) * 2*sizeof(uint64_t), "action_view: authorization is truncated" );
+         ds.skip( size_t(count.value) * 2*sizeof(uint64_t) );
+         ds >> count;
+         _data_size   = count.value;
+         _data_offset = ds.pos() - _data;
+         eosio::check( ds.remaining() >= _data_size, "action_view: data is truncated" );
+         _located = true;
+      }
+   };
+
+   namespace internal_use_do_not_use {
+      /**
+       * Buffer which the actions and context free data of the active transaction are read into. It is shared by every
+       * read, so reading the actions one after the other rarely allocates.
+       */
+      inline read_buffer& transaction_read_buffer() {
+         static read_buffer buffer;
+         return buffer;
+      }
+   }
+
+   /**
+    *  Retrieve a view of the indicated action from the active transaction. The action is read into a buffer
+    *  shared by every call, so the view is valid until the next call to get_action_view, get_action or
+    *  get_context_free_data_view.
+    *
+    *  @ingroup transaction
+    *  @param type - 0 for context free action, 1 for action
+    *  @param index - the index of the requested action
+    *  @return view of the indicated action
+    */
+   inline action_view get_action_view( uint32_t type, uint32_t index ) {
+      auto& buffer = internal_use_do_not_use::transaction_read_buffer();
+      // get_action always returns the size of the action and only copies it when it fits
+      int s = internal_use_do_not_use::get_action( type, index, buffer.data(), buffer.capacity() );
+      eosio::check( s > 0, "get_action size failed" );
+      size_t size = static_cast<size_t>(s);
+      if( size > buffer.capacity() ) {
+         buffer.reserve( size );
+         auto size2 = internal_use_do_not_use::get_action( type, index, buffer.data(), buffer.capacity() );
+         eosio::check( size == static_cast<size_t>(size2), "get_action failed" );
+      }
+      return action_view( buffer.data(), size );
+   }
+
    /**
     *  Retrieve the indicated action from the active transaction.
     *
@@ -184,14 +501,24 @@ namespace eosio {
     *  @return the indicated action
     */
    inline action get_action( uint32_t type, uint32_t index ) {
-      constexpr size_t max_stack_buffer_size = 512;
-      int s = internal_use_do_not_use::get_action( type, index, nullptr, 0 );
-      eosio::check( s > 0, "get_action size failed" );
-      size_t size = static_cast<size_t>(s);
-      char* buffer = (char*)( max_stack_buffer_size < size ? malloc(size) : alloca(size) );
-      auto size2 = internal_use_do_not_use::get_action( type, index, buffer, size );
-      eosio::check( size == static_cast<size_t>(size2), "get_action failed" );
-      return eosio::unpack<eosio::action>( buffer, size );
+      return get_action_view( type, index ).to_action();
+   }
+
+   /**
+    *  Retrieve signed_transaction.context_free_data[index] without copying it out of the buffer shared with
+    *  get_action_view, the stream is valid until the next call to either.
+    *
+    *  @ingroup transaction
+    *  @param index - the index of the context_free_data entry to retrieve
+    *  @return stream over the context_free_data entry
+    */
+   inline datastream<const char*> get_context_free_data_view( uint32_t index ) {
+      auto& buffer = internal_use_do_not_use::transaction_read_buffer();
+      int s = buffer.read( [index]( char* data, size_t size ) {
+         return internal_use_do_not_use::get_context_free_data( index, data, size );
+      });
+      eosio::check( s >= 0, "get_context_free_data failed" );
+      return { buffer.data(), static_cast<size_t>(s) };
    }
 
    /**
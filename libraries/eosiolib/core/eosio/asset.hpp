@@ -4,14 +4,51 @@
 #include "print.hpp"
 #include "check.hpp"
 #include "symbol.hpp"
+#include "powers.hpp"
 
 #include <tuple>
 #include <limits>
+#include <string_view>
 
 namespace eosio {
 
    char* write_decimal( char* begin, char* end, bool dry_run, uint64_t number, uint8_t num_decimal_places, bool negative );
 
+   namespace detail {
+      /// "00" to "99", so that decimal numbers are written two digits per division
+      inline constexpr char digit_pairs[] = "0001020304050607080910111213141516171819"
+                                            "2021222324252627282930313233343536373839"
+                                            "4041424344454647484950515253545556575859"
+                                            "6061626364656667686970717273747576777879"
+                                            "8081828384858687888990919293949596979899";
+
+      /**
+       * Writes the decimal digits of `number` right to left, ending just before `end`
+       *
+       * @return char* - The first digit written, "0" is written for 0
+       */
+      inline char* write_digits_backward( char* end, uint64_t number ) {
+         while( number >= 100 ) {
+            const char* pair = digit_pairs + (number % 100) * 2;
+            number /= 100;
+            *--end = pair[1];
+            *--end = pair[0];
+         }
+         if( number >= 10 ) {
+            *--end = digit_pairs[number * 2 + 1];
+            *--end = digit_pairs[number * 2];
+         } else {
+            *--end = '0' + number;
+         }
+         return end;
+      }
+
+      /// whether the product of two magnitudes fits in 64 bits, checked without multiplying
+      inline bool product_fits_64( uint64_t a, uint64_t b ) {
+         return a == 0 || b == 0 || __builtin_clzll(a) + __builtin_clzll(b) >= 64;
+      }
+   }
+
    /**
     *  @defgroup asset Asset
     *  @ingroup core
@@ -158,10 +195,20 @@ namespace eosio {
        * @post The amount of this asset is multiplied by a
        */
       asset& operator*=( int64_t a ) {
-         int128_t tmp = (int128_t)amount * (int128_t)a;
-         eosio::check( tmp <= max_amount, "multiplication overflow" );
-         eosio::check( tmp >= -max_amount, "multiplication underflow" );
-         amount = (int64_t)tmp;
+         const bool negative = (amount < 0) != (a < 0);
+         const uint64_t abs_amount = amount < 0 ? 0 - static_cast<uint64_t>(amount) : amount;
+         const uint64_t abs_a      = a < 0 ? 0 - static_cast<uint64_t>(a) : a;
+         uint64_t product = max_amount + 1ull;
+         // most products fit in 64 bits and don't need the 128-bit multiplication of __multi3
+         if( detail::product_fits_64( abs_amount, abs_a ) ) {
+            product = abs_amount * abs_a;
+         } else {
+            uint128_t tmp = (uint128_t)abs_amount * abs_a;
+            if( tmp <= max_amount )
+               product = static_cast<uint64_t>(tmp);
+         }
+         eosio::check( product <= max_amount, negative ? "multiplication underflow" : "multiplication overflow" );
+         amount = negative ? -static_cast<int64_t>(product) : static_cast<int64_t>(product);
          return *this;
       }
 
@@ -333,23 +380,95 @@ namespace eosio {
        *  @post If the output string fits within the range [begin, end) and dry_run == false, the range [begin, returned pointer) contains the string representation of the asset. Nothing is written if dry_run == true or returned pointer > end (insufficient space) or if returned pointer < begin (overflow in calculating desired end).
        */
       char* write_as_string( char* begin, char* end, bool dry_run = false )const {
-         bool negative = (amount < 0);
-         uint64_t abs_amount = static_cast<uint64_t>(negative ? -amount : amount);
-         // 0 <= abs_amount <= std::numeric_limits<int64_t>::max() < 10^19 < std::numeric_limits<uint64_t>::max()
+         const bool negative = (amount < 0);
+         // 0 <= abs_amount <= 2^63 < 10^19 < std::numeric_limits<uint64_t>::max()
+         const uint64_t abs_amount = negative ? 0 - static_cast<uint64_t>(amount) : static_cast<uint64_t>(amount);
+         const uint8_t precision = symbol.precision();
+
+         // the digits are formatted once up front, which gives the exact length without a dry run
+         char digits[20];
+         char* const digits_end = digits + sizeof(digits);
+         const char* first_digit = detail::write_digits_backward( digits_end, abs_amount );
+         const uint32_t num_digits = digits_end - first_digit;
+         const uint32_t integer_digits = num_digits > precision ? num_digits - precision : 1;
+         const uint32_t code_length = symbol.code().length();
+
+         const uint32_t size = negative + integer_digits + (precision ? precision + 1 : 0) + 1 + code_length;
+         char* actual_end = begin + size;
+         if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+
+         char* out = begin;
+         if( negative )
+            *out++ = '-';
+         if( num_digits > precision ) {
+            __builtin_memcpy( out, first_digit, integer_digits );
+            first_digit += integer_digits;
+         } else {
+            *out = '0';
+         }
+         out += integer_digits;
+         if( precision ) {
+            *out++ = '.';
+            const uint32_t fraction_digits = digits_end - first_digit;
+            __builtin_memset( out, '0', precision - fraction_digits );
+            out += precision - fraction_digits;
+            __builtin_memcpy( out, first_digit, fraction_digits );
+            out += fraction_digits;
+         }
+         *out++ = ' ';
+         for( uint64_t code = symbol.code().raw(); code; code >>= 8 )
+            *out++ = static_cast<char>(code & 0xFF);
 
-         uint8_t precision = symbol.precision();
+         return actual_end;
+      }
 
-         int sufficient_size = std::max(static_cast<int>(precision), 19) + 11;
-         if( dry_run || (begin + sufficient_size < begin) || (begin + sufficient_size > end) ) {
-            char* start_of_symbol = write_decimal( begin, end, true, abs_amount, precision, negative ) + 1;
-            char* actual_end = symbol.code().write_as_string( start_of_symbol, end, true );
-            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
+      /**
+       * Parses an %asset from its string representation, e.g. "-1.0000 EOS", without allocating
+       *
+       * The precision of the symbol is the number of digits after the decimal point. Spaces before the
+       * amount and after the symbol code are ignored.
+       *
+       * @param str - The amount, a space and the symbol code
+       * @return asset - The parsed asset
+       */
+      static asset from_string( std::string_view str ) {
+         const size_t first = str.find_first_not_of( ' ' );
+         eosio::check( first != std::string_view::npos, "asset string is empty" );
+         str.remove_prefix( first );
+         str.remove_suffix( str.size() - 1 - str.find_last_not_of( ' ' ) );
+
+         const size_t space = str.find( ' ' );
+         eosio::check( space != std::string_view::npos, "asset amount and symbol should be separated with a space" );
+         std::string_view amount_str = str.substr( 0, space );
+         const std::string_view code_str = str.substr( str.find_first_not_of( ' ', space ) );
+
+         const bool negative = amount_str[0] == '-';
+         if( negative )
+            amount_str.remove_prefix( 1 );
+
+         uint64_t value = 0;
+         size_t dot = std::string_view::npos;
+         for( size_t i = 0; i < amount_str.size(); ++i ) {
+            const char c = amount_str[i];
+            if( c == '.' && dot == std::string_view::npos ) {
+               dot = i;
+               continue;
+            }
+            eosio::check( c >= '0' && c <= '9', "asset amount must be a decimal number" );
+            eosio::check( value <= static_cast<uint64_t>(max_amount) / 10, "magnitude of asset amount must be less than 2^62" );
+            value = value * 10 + (c - '0');
          }
+         size_t precision = 0;
+         if( dot != std::string_view::npos ) {
+            eosio::check( dot > 0 && dot + 1 < amount_str.size(), "asset amount needs digits before and after the decimal point" );
+            precision = amount_str.size() - dot - 1;
+         } else {
+            eosio::check( !amount_str.empty(), "asset amount must be a decimal number" );
+         }
+         eosio::check( precision <= std::numeric_limits<uint8_t>::max(), "precision of asset is too large" );
 
-         char* end_of_number = write_decimal( begin, end, false, abs_amount, precision, negative );
-         *(end_of_number) = ' ';
-
-         return symbol.code().write_as_string( end_of_number + 1, end );
+         const int64_t amount = static_cast<int64_t>(value);
+         return asset{ negative ? -amount : amount, eosio::symbol{ symbol_code{ code_str }, static_cast<uint8_t>(precision) } };
       }
 
       /**
@@ -495,4 +614,69 @@ namespace eosio {
 
       EOSLIB_SERIALIZE( extended_asset, (quantity)(contract) )
    };
+
+   /**
+    *  Fixed-point arithmetic on amounts, such as fees and prices, with overflow checks
+    *
+    *  @ingroup asset
+    */
+   namespace asset_math {
+      /**
+       *  Computes a * b / c with a single 128-bit intermediate, so that the product can't overflow.
+       *  The quotient is rounded toward zero, or toward positive infinity when `round_up` is true.
+       *
+       *  @return int64_t - The quotient, which must fit in an int64_t
+       */
+      inline int64_t muldiv( int64_t a, int64_t b, int64_t c, bool round_up = false ) {
+         eosio::check( c != 0, "divide by zero" );
+         const bool negative = ((a < 0) != (b < 0)) != (c < 0);
+         const uint64_t abs_a = a < 0 ? 0 - static_cast<uint64_t>(a) : a;
+         const uint64_t abs_b = b < 0 ? 0 - static_cast<uint64_t>(b) : b;
+         const uint64_t abs_c = c < 0 ? 0 - static_cast<uint64_t>(c) : c;
+
+         uint64_t quotient;
+         bool inexact;
+         if( detail::product_fits_64( abs_a, abs_b ) ) {
+            // only 64-bit operations when the product fits
+            const uint64_t product = abs_a * abs_b;
+            quotient = product / abs_c;
+            inexact = product % abs_c != 0;
+         } else {
+            const uint128_t product = (uint128_t)abs_a * abs_b;
+            const uint128_t q = product / abs_c;
+            eosio::check( q <= std::numeric_limits<uint64_t>::max(), "muldiv overflow" );
+            quotient = static_cast<uint64_t>(q);
+            inexact = q * abs_c != product;
+         }
+         if( round_up && inexact && !negative ) {
+            eosio::check( quotient < std::numeric_limits<uint64_t>::max(), "muldiv overflow" );
+            ++quotient;
+         }
+         eosio::check( quotient <= (negative ? 0 - static_cast<uint64_t>(std::numeric_limits<int64_t>::min())
+                                              : static_cast<uint64_t>(std::numeric_limits<int64_t>::max())), "muldiv overflow" );
+         return negative ? static_cast<int64_t>(0 - quotient) : static_cast<int64_t>(quotient);
+      }
+
+      /**
+       *  Computes quantity * b / c in the symbol of quantity, e.g. a fee of 0.25% is
+       *  `muldiv(quantity, 25, 10000, true)`
+       *
+       *  @return asset - The result, whose amount must be within the range of an asset
+       */
+      inline asset muldiv( const asset& quantity, int64_t b, int64_t c, bool round_up = false ) {
+         return asset{ muldiv( quantity.amount, b, c, round_up ), quantity.symbol };
+      }
+
+      /**
+       *  Converts quantity at `price`, the amount of the result for one whole unit of quantity, into
+       *  the symbol of price. The result is rounded down, e.g. 2.0000 EOS at 0.50 USD is 1.00 USD.
+       *
+       *  @return asset - The converted asset
+       */
+      inline asset convert( const asset& quantity, const asset& price, bool round_up = false ) {
+         const uint8_t precision = quantity.symbol.precision();
+         eosio::check( precision <= 18, "precision of asset is too large" );
+         return asset{ muldiv( quantity.amount, price.amount, static_cast<int64_t>(eosio::pow<10>(precision)), round_up ), price.symbol };
+      }
+   }
 }
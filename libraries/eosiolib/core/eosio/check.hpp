@@ -6,6 +6,17 @@
 
 #include <alloca.h>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifdef EOSIO_PRINT_BUFFER
+#include "print.hpp"
+#endif
+
+#ifndef EOSIO_CHECK_MESSAGE_SIZE
+#define EOSIO_CHECK_MESSAGE_SIZE 256
+#endif
 
 namespace eosio {
 
@@ -20,6 +31,107 @@ namespace eosio {
          __attribute__((eosio_wasm_import))
          void eosio_assert_code( uint32_t test, uint64_t code );
       }
+
+      /// writes out what print() buffered when compiled with EOSIO_PRINT_BUFFER
+      inline void flush_print_buffer() {
+#ifdef EOSIO_PRINT_BUFFER
+         print_buffer::flush();
+#endif
+      }
+
+      /**
+       * Message of a failed check, formatted on the stack. Output past `capacity` characters is
+       * dropped.
+       */
+      class check_message {
+         public:
+            static constexpr size_t capacity = EOSIO_CHECK_MESSAGE_SIZE;
+
+            const char* data()const { return _buffer; }
+            size_t size()const { return _size; }
+
+            void write(const char* s, size_t len) {
+               if (len > capacity - _size)
+                  len = capacity - _size;
+               __builtin_memcpy(_buffer + _size, s, len);
+               _size += len;
+            }
+
+            template <typename T>
+            void write_uint(T v) {
+               char digits[40];
+               char* begin = digits + sizeof(digits);
+               do {
+                  *--begin = '0' + v % 10;
+                  v /= 10;
+               } while (v);
+               write(begin, digits + sizeof(digits) - begin);
+            }
+
+            template <typename T>
+            void write_value(const T& v) {
+               if constexpr (std::is_same<T, bool>::value) {
+                  v ? write("true", 4) : write("false", 5);
+               } else if constexpr (std::is_same<T, char>::value) {
+                  write(&v, 1);
+               } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+                  using unsigned_t = std::make_unsigned_t<T>;
+                  if (v < 0) {
+                     write("-", 1);
+                     write_uint(unsigned_t(-static_cast<unsigned_t>(v)));
+                  } else {
+                     write_uint(unsigned_t(v));
+                  }
+               } else if constexpr (std::is_integral<T>::value) {
+                  write_uint(v);
+               } else if constexpr (std::is_convertible<const T&, const char*>::value) {
+                  const char* s = v;
+                  write(s, __builtin_strlen(s));
+               } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+                  std::string_view s = v;
+                  write(s.data(), s.size());
+               } else if constexpr (has_write_as_string<T>(0)) {
+                  // name, symbol_code, symbol and asset format themselves without allocating
+                  char* end = v.write_as_string(_buffer + _size, _buffer + capacity);
+                  if (end >= _buffer + _size && end <= _buffer + capacity)
+                     _size = end - _buffer;
+               } else {
+                  const auto s = v.to_string();
+                  write(s.data(), s.size());
+               }
+            }
+
+            /// writes `fmt` with each `%` replaced by the next argument, like print_f()
+            void format(const char* fmt) {
+               write(fmt, __builtin_strlen(fmt));
+            }
+
+            template <typename Arg, typename... Args>
+            void format(const char* fmt, const Arg& arg, const Args&... rest) {
+               const char* s = fmt;
+               while (*s != '\0' && *s != '%')
+                  ++s;
+               write(fmt, s - fmt);
+               if (*s == '\0')
+                  return;
+               write_value(arg);
+               format(s + 1, rest...);
+            }
+
+         private:
+            char   _buffer[capacity];
+            size_t _size = 0;
+
+            template <typename T>
+            static constexpr auto has_write_as_string(int) -> decltype(std::declval<const T&>().write_as_string((char*)nullptr, (char*)nullptr), bool()) {
+               return true;
+            }
+            template <typename T>
+            static constexpr bool has_write_as_string(long) {
+               return false;
+            }
+      };
+
    }
 
    /**
@@ -31,6 +143,9 @@ namespace eosio {
    /**
     *  Assert if the predicate fails and use the supplied message.
     *
+    *  Contracts compiled with `eosio-cpp -error-codes` call check(bool, uint64_t) with the error code
+    *  of a literal message instead, and the ABI maps the code back to the message.
+    *
     *  @ingroup system
     *
     *  Example:
@@ -40,6 +155,7 @@ namespace eosio {
     */
    inline void check(bool pred, const char* msg) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert(false, msg);
       }
    }
@@ -56,6 +172,7 @@ namespace eosio {
     */
    inline void check(bool pred, const std::string& msg) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert(false, msg.c_str());
       }
    }
@@ -72,6 +189,7 @@ namespace eosio {
     */
    inline void check(bool pred, std::string&& msg) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert(false, msg.c_str());
       }
    }
@@ -89,10 +207,37 @@ namespace eosio {
     */
    inline void check(bool pred, const char* msg, size_t n) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert_message(false, msg, n);
       }
    }
 
+   /**
+    *  Assert if the predicate fails and use the supplied message, in which each `%` is replaced by the
+    *  next argument. The message is only formatted when the predicate fails, into a buffer of
+    *  `EOSIO_CHECK_MESSAGE_SIZE` (256 by default) characters on the stack, so a passing check costs no
+    *  more than the comparison.
+    *
+    *  Arguments can be strings, integers, bools, chars, types with a `write_as_string(char*, char*)`
+    *  member such as name and asset, and types with a `to_string()` member.
+    *
+    *  @ingroup system
+    *
+    *  Example:
+    *  @code
+    *  eosio::check_f(quantity.amount > 0, "quantity % of % must be positive", quantity, from);
+    *  @endcode
+    */
+   template <typename... Args>
+   inline void check_f(bool pred, const char* fmt, const Args&... args) {
+      if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
+         internal_use_do_not_use::check_message msg;
+         msg.format(fmt, args...);
+         internal_use_do_not_use::eosio_assert_message(false, msg.data(), msg.size());
+      }
+   }
+
    /**
     *  Assert if the predicate fails and use a subset of the supplied message.
     *
@@ -106,6 +251,7 @@ namespace eosio {
     */
    inline void check(bool pred, const std::string& msg, size_t n) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert_message(false, msg.c_str(), n);
       }
    }
@@ -122,6 +268,7 @@ namespace eosio {
     */
    inline void check(bool pred, uint64_t code) {
       if (!pred) {
+         internal_use_do_not_use::flush_print_buffer();
          internal_use_do_not_use::eosio_assert_code(false, code);
       }
    }
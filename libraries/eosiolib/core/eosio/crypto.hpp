@@ -8,7 +8,9 @@
 #include "varint.hpp"
 #include "serialize.hpp"
 
+#include <alloca.h>
 #include <array>
+#include <cstdlib>
 
 namespace eosio {
 
@@ -317,6 +319,33 @@ namespace eosio {
     */
    eosio::checksum160 ripemd160( const char* data, uint32_t length );
 
+   /**
+    *  Hashes the packed representation of `value` using SHA256, equivalent to `sha256` of the result of `pack`.
+    *
+    *  The value is packed on the stack when it is small enough, and otherwise into a single allocation of exactly
+    *  its packed size, instead of the vector returned by `pack`.
+    *
+    *  @ingroup crypto
+    *  @param value - Value to pack and hash
+    *  @return eosio::checksum256 - Computed digest
+    */
+   template<typename T>
+   eosio::checksum256 sha256_packed( const T& value ) {
+      constexpr size_t max_stack_buffer_size = 512;
+      size_t size = pack_size( value );
+      //using malloc/free here potentially is not exception-safe, although WASM doesn't support exceptions
+      char* buffer = (char*)( max_stack_buffer_size < size ? malloc(size) : alloca(size) );
+
+      datastream<char*> ds( buffer, size );
+      ds << value;
+      eosio::checksum256 digest = sha256( buffer, size );
+
+      if ( max_stack_buffer_size < size ) {
+         free(buffer);
+      }
+      return digest;
+   }
+
    /**
     *  Calculates the public key used for a given signature on a given digest.
     *
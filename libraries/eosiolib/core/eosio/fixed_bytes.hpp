@@ -58,35 +58,39 @@ namespace eosio {
          template<bool... bs>
          using all_true = std::is_same< bool_pack<bs..., true>, bool_pack<true, bs...> >;
 
-         template<typename Word, size_t NumWords>
+         static uint64_t load_uint64(const uint8_t* p) {
+            uint64_t w;
+            __builtin_memcpy(&w, p, sizeof(w));
+            return w;
+         }
+
+         template<typename Word>
+         static Word to_big_endian(Word w) {
+            if constexpr (sizeof(Word) == 1)
+               return w;
+            else if constexpr (sizeof(Word) == 2)
+               return __builtin_bswap16(w);
+            else if constexpr (sizeof(Word) == 4)
+               return __builtin_bswap32(w);
+            else if constexpr (sizeof(Word) == 8)
+               return __builtin_bswap64(w);
+            else
+               return (Word(__builtin_bswap64(uint64_t(w))) << 64) | __builtin_bswap64(uint64_t(w >> 64));
+         }
+
+         // the words are laid out one after another, each with its most significant byte first
+         template<typename Word>
          static void set_from_word_sequence(const Word* arr_begin, const Word* arr_end, fixed_bytes<Size>& key)
          {
-            auto itr = key._data.begin();
-            word_t temp_word = 0;
-            const size_t sub_word_shift = 8 * sizeof(Word);
-            const size_t num_sub_words = sizeof(word_t) / sizeof(Word);
-            auto sub_words_left = num_sub_words;
-            for( auto w_itr = arr_begin; w_itr != arr_end; ++w_itr ) {
-               if( sub_words_left > 1 ) {
-                   temp_word |= static_cast<word_t>(*w_itr);
-                   temp_word <<= sub_word_shift;
-                   --sub_words_left;
-                   continue;
-               }
-
-               eosio::check( sub_words_left == 1, "unexpected error in fixed_bytes constructor" );
-               temp_word |= static_cast<word_t>(*w_itr);
-               sub_words_left = num_sub_words;
-
-               *itr = temp_word;
-               temp_word = 0;
-               ++itr;
-            }
-            if( sub_words_left != num_sub_words ) {
-               if( sub_words_left > 1 )
-                  temp_word <<= 8 * (sub_words_left-1);
-               *itr = temp_word;
+            uint8_t* itr = key._data.data();
+            for( auto w_itr = arr_begin; w_itr != arr_end; ++w_itr, itr += sizeof(Word) ) {
+               Word w = to_big_endian(*w_itr);
+               __builtin_memcpy(itr, &w, sizeof(Word));
             }
+            // zero what the words didn't cover and the padding after the last byte
+            uint8_t* end = key._data.data() + key._data.size();
+            uint8_t* pad = key._data.data() + Size;
+            __builtin_memset(itr < pad ? itr : pad, 0, end - (itr < pad ? itr : pad));
          }
 
       public:
@@ -117,7 +121,7 @@ namespace eosio {
          */
          fixed_bytes(const std::array<word_t, num_words()>& arr)
          {
-           std::copy(arr.begin(), arr.end(), _data.begin());
+            set_from_word_sequence(arr.data(), arr.data() + arr.size(), *this);
          }
 
          /**
@@ -136,7 +140,7 @@ namespace eosio {
                            "size of the backing word size is not divisible by the size of the array element" );
             static_assert( sizeof(Word) * NumWords <= Size, "too many words supplied to fixed_bytes constructor" );
 
-            set_from_word_sequence<Word, NumWords>(arr.data(), arr.data() + arr.size(), *this);
+            set_from_word_sequence(arr.data(), arr.data() + arr.size(), *this);
          }
 
          /**
@@ -155,7 +159,7 @@ namespace eosio {
                            "size of the backing word size is not divisible by the size of the array element" );
             static_assert( sizeof(Word) * NumWords <= Size, "too many words supplied to fixed_bytes constructor" );
 
-            set_from_word_sequence<Word, NumWords>(arr, arr + NumWords, *this);
+            set_from_word_sequence(arr, arr + NumWords, *this);
          }
 
          /**
@@ -183,33 +187,70 @@ namespace eosio {
 
             fixed_bytes<Size> key;
             std::array<FirstWord, 1+sizeof...(Rest)> arr{{ first_word, rest... }};
-            set_from_word_sequence<FirstWord, 1+sizeof...(Rest)>(arr.data(), arr.data() + arr.size(), key);
+            set_from_word_sequence(arr.data(), arr.data() + arr.size(), key);
             return key;
          }
 
          /**
-          * Get the contained std::array
+          * Get the contents as num_words() words, the key format of the db_idx256 intrinsics. Each word is
+          * built from two 64-bit loads rather than byte by byte.
+          *
+          * The words hold the same values as before the bytes were stored in serialization order, but they are
+          * returned by value rather than by reference.
+          */
+         std::array<word_t, num_words()> get_array()const {
+            std::array<word_t, num_words()> arr;
+            for( size_t i = 0; i < num_words(); ++i ) {
+               const uint8_t* p = _data.data() + i * sizeof(word_t);
+               arr[i] = (word_t(__builtin_bswap64(load_uint64(p))) << 64) | __builtin_bswap64(load_uint64(p + 8));
+            }
+            return arr;
+         }
+
+         /**
+          * Get the bytes, in the same order as they are serialized
+          */
+         uint8_t* bytes() { return _data.data(); }
+
+         /**
+          * Get the bytes, in the same order as they are serialized
+          */
+         const uint8_t* bytes()const { return _data.data(); }
+
+         /**
+          * Get the number of bytes
           */
-         const auto& get_array()const { return _data; }
+         static constexpr size_t byte_size() { return Size; }
 
          /**
-          * Get the underlying data of the contained std::array
+          * Get the storage as num_words() words
+          *
+          * @deprecated The bytes are stored in serialization order, so these words no longer hold the values of
+          * get_array(). Use bytes() and byte_size() for the bytes, or get_array() for the words.
           */
-         auto data() { return _data.data(); }
+         [[deprecated("fixed_bytes stores its bytes in serialization order, use bytes() or get_array()")]]
+         word_t* data() { return reinterpret_cast<word_t*>(_data.data()); }
 
          /// @cond INTERNAL
 
          /**
-          * Get the underlying data of the contained std::array
+          * Get the storage as num_words() words
+          *
+          * @deprecated The bytes are stored in serialization order, so these words no longer hold the values of
+          * get_array(). Use bytes() and byte_size() for the bytes, or get_array() for the words.
           */
-         auto data()const { return _data.data(); }
+         [[deprecated("fixed_bytes stores its bytes in serialization order, use bytes() or get_array()")]]
+         const word_t* data()const { return reinterpret_cast<const word_t*>(_data.data()); }
 
          /// @endcond
 
          /**
-          * Get the size of the contained std::array
+          * Get the number of words of the storage, num_words()
+          *
+          * @deprecated Use byte_size() for the number of bytes, or num_words().
           */
-         auto size()const { return _data.size(); }
+         [[deprecated("use byte_size() for the number of bytes, or num_words()")]]
+         constexpr size_t size()const { return num_words(); }
 
 
          /**
@@ -219,27 +260,7 @@ namespace eosio {
           */
          std::array<uint8_t, Size> extract_as_byte_array()const {
             std::array<uint8_t, Size> arr;
-
-            const size_t num_sub_words = sizeof(word_t);
-
-            auto arr_itr  = arr.begin();
-            auto data_itr = _data.begin();
-
-            for( size_t counter = _data.size(); counter > 0; --counter, ++data_itr ) {
-               size_t sub_words_left = num_sub_words;
-
-               auto temp_word = *data_itr;
-               if( counter == 1 ) { // If last word in _data array...
-                  sub_words_left -= padded_bytes();
-                  temp_word >>= 8*padded_bytes();
-               }
-               for( ; sub_words_left > 0; --sub_words_left ) {
-                  *(arr_itr + sub_words_left - 1) = static_cast<uint8_t>(temp_word & 0xFF);
-                  temp_word >>= 8;
-               }
-               arr_itr += num_sub_words;
-            }
-
+            __builtin_memcpy(arr.data(), _data.data(), Size);
             return arr;
          }
 
@@ -249,8 +270,7 @@ namespace eosio {
           * @param val to be printed
           */
          inline void print()const {
-            auto arr = extract_as_byte_array();
-            printhex(static_cast<const void*>(arr.data()), arr.size());
+            printhex(static_cast<const void*>(_data.data()), Size);
          }
 
          /// @cond OPERATORS
@@ -271,7 +291,26 @@ namespace eosio {
 
       private:
 
-         std::array<word_t, num_words()> _data;
+         static bool equal(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
+            for( size_t i = 0; i < c1._data.size(); i += sizeof(uint64_t) )
+               if( load_uint64(c1._data.data() + i) != load_uint64(c2._data.data() + i) )
+                  return false;
+            return true;
+         }
+
+         // only the first pair of 64-bit words which differ is byte swapped to order them
+         static int compare(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
+            for( size_t i = 0; i < c1._data.size(); i += sizeof(uint64_t) ) {
+               uint64_t w1 = load_uint64(c1._data.data() + i);
+               uint64_t w2 = load_uint64(c2._data.data() + i);
+               if( w1 != w2 )
+                  return __builtin_bswap64(w1) < __builtin_bswap64(w2) ? -1 : 1;
+            }
+            return 0;
+         }
+
+         /// The bytes in serialization order, padded with zeros to num_words() words
+         alignas(16) std::array<uint8_t, num_words() * sizeof(word_t)> _data;
     };
 
   /// @cond IMPLEMENTATIONS
@@ -285,7 +324,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator ==(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data == c2._data;
+      return fixed_bytes<Size>::equal(c1, c2);
    }
 
    /**
@@ -297,7 +336,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator !=(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data != c2._data;
+      return !fixed_bytes<Size>::equal(c1, c2);
    }
 
    /**
@@ -309,7 +348,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator >(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
-      return c1._data > c2._data;
+      return fixed_bytes<Size>::compare(c1, c2) > 0;
    }
 
    /**
@@ -321,7 +360,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator <(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data < c2._data;
+      return fixed_bytes<Size>::compare(c1, c2) < 0;
    }
 
    /**
@@ -333,7 +372,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator >=(const fixed_bytes<Size>& c1, const fixed_bytes<Size>& c2) {
-      return c1._data >= c2._data;
+      return fixed_bytes<Size>::compare(c1, c2) >= 0;
    }
 
    /**
@@ -345,7 +384,7 @@ namespace eosio {
     */
    template<size_t Size>
    bool operator <=(const fixed_bytes<Size> &c1, const fixed_bytes<Size> &c2) {
-      return c1._data <= c2._data;
+      return fixed_bytes<Size>::compare(c1, c2) <= 0;
    }
 
 
@@ -364,8 +403,7 @@ namespace eosio {
     */
    template<typename DataStream, size_t Size>
    inline DataStream& operator<<(DataStream& ds, const fixed_bytes<Size>& d) {
-      auto arr = d.extract_as_byte_array();
-      ds.write( (const char*)arr.data(), arr.size() );
+      ds.write( (const char*)d.bytes(), Size );
       return ds;
    }
 
@@ -380,9 +418,9 @@ namespace eosio {
     */
    template<typename DataStream, size_t Size>
    inline DataStream& operator>>(DataStream& ds, fixed_bytes<Size>& d) {
-      std::array<uint8_t, Size> arr;
-      ds.read( (char*)arr.data(), arr.size() );
-      d = fixed_bytes<Size>( arr );
+      if constexpr ( fixed_bytes<Size>::padded_bytes() > 0 )
+         d = fixed_bytes<Size>();
+      ds.read( (char*)d.bytes(), Size );
       return ds;
    }
 
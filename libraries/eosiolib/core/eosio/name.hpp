@@ -7,6 +7,7 @@
 #include "check.hpp"
 #include "serialize.hpp"
 
+#include <array>
 #include <string>
 #include <string_view>
 
@@ -18,6 +19,29 @@ namespace eosio {
       }
    }
 
+   namespace detail {
+      /// marks the characters which can't be part of a %name in `name_char_values`
+      static constexpr uint8_t invalid_name_char = 0x20;
+
+      constexpr std::array<uint8_t, 256> make_name_char_values() {
+         std::array<uint8_t, 256> values{};
+         for( auto& v : values )
+            v = invalid_name_char;
+         values['.'] = 0;
+         for( int c = '1'; c <= '5'; ++c )
+            values[c] = (c - '1') + 1;
+         for( int c = 'a'; c <= 'z'; ++c )
+            values[c] = (c - 'a') + 6;
+         return values;
+      }
+
+      /// 5-bit value of each character of a %name, `invalid_name_char` for the others
+      inline constexpr std::array<uint8_t, 256> name_char_values = make_name_char_values();
+
+      /// character of each 5-bit value of a %name
+      inline constexpr char name_charmap[] = ".12345abcdefghijklmnopqrstuvwxyz";
+   }
+
    /**
     * @defgroup name
     * @ingroup core
@@ -83,18 +107,25 @@ namespace eosio {
             return;
          }
 
+         // invalid characters are collected in `invalid` and checked once, after the loop
          auto n = std::min( (uint32_t)str.size(), (uint32_t)12u );
+         uint8_t invalid = 0;
          for( decltype(n) i = 0; i < n; ++i ) {
-            value <<= 5;
-            value |= char_to_value( str[i] );
+            uint8_t v = detail::name_char_values[static_cast<uint8_t>(str[i])];
+            invalid |= v;
+            value = (value << 5) | (v & 0x1Full);
          }
          value <<= ( 4 + 5*(12 - n) );
          if( str.size() == 13 ) {
-            uint64_t v = char_to_value( str[12] );
-            if( v > 0x0Full ) {
+            uint8_t v = detail::name_char_values[static_cast<uint8_t>(str[12])];
+            invalid |= v;
+            if( !(invalid & detail::invalid_name_char) && v > 0x0F ) {
                eosio::check(false, "thirteenth character in name cannot be a letter that comes after j");
             }
-            value |= v;
+            value |= v & 0x0Full;
+         }
+         if( invalid & detail::invalid_name_char ) {
+            eosio::check( false, "character is not in allowed character set for names" );
          }
       }
 
@@ -105,36 +136,27 @@ namespace eosio {
        *  @return constexpr char - Converted value
        */
       static constexpr uint8_t char_to_value( char c ) {
-         if( c == '.')
-            return 0;
-         else if( c >= '1' && c <= '5' )
-            return (c - '1') + 1;
-         else if( c >= 'a' && c <= 'z' )
-            return (c - 'a') + 6;
-         else
+         uint8_t v = detail::name_char_values[static_cast<uint8_t>(c)];
+         if( v == detail::invalid_name_char ) {
             eosio::check( false, "character is not in allowed character set for names" );
-
-         return 0; // control flow will never reach here; just added to suppress warning
+            return 0; // control flow will never reach here; just added to suppress warning
+         }
+         return v;
       }
 
       /**
        *  Returns the length of the %name
        */
       constexpr uint8_t length()const {
-         constexpr uint64_t mask = 0xF800000000000000ull;
-
          if( value == 0 )
             return 0;
 
-         uint8_t l = 0;
-         uint8_t i = 0;
-         for( auto v = value; i < 13; ++i, v <<= 5 ) {
-            if( (v & mask) > 0 ) {
-               l = i;
-            }
-         }
-
-         return l + 1;
+         // the last character which isn't a dot holds the lowest bit which is set, the 13th
+         // character is in the low 4 bits and the others in 5 bits each above it
+         uint32_t trailing_zeros = __builtin_ctzll( value );
+         if( trailing_zeros < 4 )
+            return 13;
+         return 12 - (trailing_zeros - 4) / 5;
       }
 
       /**
@@ -195,24 +217,23 @@ namespace eosio {
        *  @post If the output string fits within the range [begin, end) and dry_run == false, the range [begin, returned pointer) contains the string representation of the %name. Nothing is written if dry_run == true or returned pointer > end (insufficient space) or if returned pointer < begin (overflow in calculating desired end).
        */
       char* write_as_string( char* begin, char* end, bool dry_run = false )const {
-         static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
-         constexpr uint64_t mask = 0xF800000000000000ull;
-
-         if( dry_run || (begin + 13 < begin) || (begin + 13 > end) ) {
-            char* actual_end = begin + length();
-            if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
-         }
-
-         auto v = value;
-         for( auto i = 0; i < 13; ++i, v <<= 5 ) {
-            if( v == 0 ) return begin;
+         const uint8_t len = length();
+         char* actual_end = begin + len;
+         if( dry_run || (actual_end < begin) || (actual_end > end) ) return actual_end;
 
-            auto indx = (v & mask) >> (i == 12 ? 60 : 59);
-            *begin = charmap[indx];
-            ++begin;
-         }
+         write_chars( begin, len );
+         return actual_end;
+      }
 
-         return begin;
+      /**
+       *  Returns the %name as characters without allocating, the characters after length() are null
+       *
+       *  @brief Writes the %name into an array of 13 characters
+       */
+      constexpr std::array<char, 13> to_char_array()const {
+         std::array<char, 13> chars{};
+         write_chars( chars.data(), length() );
+         return chars;
       }
 
       /**
@@ -232,7 +253,13 @@ namespace eosio {
        * @param name to be printed
        */
       inline void print()const {
+#ifdef EOSIO_PRINT_BUFFER
+        char buffer[13];
+        auto end = write_as_string( buffer, buffer + sizeof(buffer) );
+        print_buffer::write( buffer, end - buffer );
+#else
         internal_use_do_not_use::printn(value);
+#endif
       }
 
       /// @cond INTERNAL
@@ -268,6 +295,19 @@ namespace eosio {
 
       uint64_t value = 0;
 
+   private:
+      // the first `len` characters, each one is looked up by shifting its 5 bits down
+      constexpr void write_chars( char* out, uint8_t len )const {
+         const uint8_t n = len < 12 ? len : 12;
+         for( uint8_t i = 0; i < n; ++i ) {
+            out[i] = detail::name_charmap[(value >> (59 - 5*i)) & 0x1Full];
+         }
+         if( len == 13 ) {
+            out[12] = detail::name_charmap[value & 0x0Full];
+         }
+      }
+
+   public:
       EOSLIB_SERIALIZE( name, (value) )
    };
 
@@ -46,6 +46,86 @@ namespace eosio {
       }
    };
 
+#ifdef EOSIO_PRINT_BUFFER
+#ifndef EOSIO_PRINT_BUFFER_SIZE
+#define EOSIO_PRINT_BUFFER_SIZE 1024
+#endif
+
+   /**
+    *  Console output buffer of contracts compiled with `-DEOSIO_PRINT_BUFFER`.
+    *
+    *  In this mode print() formats strings, integers, names and hex into a buffer in linear memory
+    *  instead of calling one intrinsic per value. The buffer is written with a single `prints_l` when
+    *  it is full, when check() fails, and at the end of the action.
+    *
+    *  @ingroup console
+    */
+   class print_buffer {
+      public:
+         static constexpr size_t capacity = EOSIO_PRINT_BUFFER_SIZE;
+
+         /// Writes the buffered output to the console
+         static void flush() {
+            if (_size) {
+               internal_use_do_not_use::prints_l(_buffer, _size);
+               _size = 0;
+            }
+         }
+
+         static void write(const char* s, size_t len) {
+            if (capacity - _size < len) {
+               flush();
+               if (len > capacity) {
+                  internal_use_do_not_use::prints_l(s, len);
+                  return;
+               }
+            }
+            __builtin_memcpy(_buffer + _size, s, len);
+            _size += len;
+         }
+
+         static void write(char c) {
+            if (_size == capacity)
+               flush();
+            _buffer[_size++] = c;
+         }
+
+         static void write_uint(uint64_t v) {
+            char digits[20];
+            char* begin = digits + sizeof(digits);
+            do {
+               *--begin = '0' + v % 10;
+               v /= 10;
+            } while (v);
+            write(begin, digits + sizeof(digits) - begin);
+         }
+
+         static void write_int(int64_t v) {
+            if (v < 0) {
+               write('-');
+               write_uint(-static_cast<uint64_t>(v));
+            } else {
+               write_uint(v);
+            }
+         }
+
+         static void write_hex(const void* ptr, uint32_t size) {
+            static const char hex[] = "0123456789abcdef";
+            const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+            for (uint32_t i = 0; i < size; ++i) {
+               if (capacity - _size < 2)
+                  flush();
+               _buffer[_size++] = hex[bytes[i] >> 4];
+               _buffer[_size++] = hex[bytes[i] & 0x0f];
+            }
+         }
+
+      private:
+         inline static char   _buffer[capacity];
+         inline static size_t _size = 0;
+   };
+#endif
+
    /**
     *  @defgroup console Console
     *  @ingroup core
@@ -75,7 +155,11 @@ namespace eosio {
     *  @param size - number of bytes to print
     */
    inline void printhex( const void* ptr, uint32_t size) {
+#ifdef EOSIO_PRINT_BUFFER
+      print_buffer::write_hex(ptr, size);
+#else
       internal_use_do_not_use::printhex(ptr, size);
+#endif
    }
 
    /**
@@ -86,7 +170,11 @@ namespace eosio {
     *  @param len - number of chars to print
     */
    inline void printl( const char* ptr, size_t len ) {
+#ifdef EOSIO_PRINT_BUFFER
+     print_buffer::write(ptr, len);
+#else
      internal_use_do_not_use::prints_l(ptr, len);
+#endif
    }
 
    /**
@@ -96,7 +184,11 @@ namespace eosio {
     *  @param ptr - a null terminated string
     */
    inline void print( const char* ptr ) {
+#ifdef EOSIO_PRINT_BUFFER
+     print_buffer::write(ptr, __builtin_strlen(ptr));
+#else
      internal_use_do_not_use::prints(ptr);
+#endif
    }
 
    /**
@@ -107,12 +199,22 @@ namespace eosio {
    template <typename T, std::enable_if_t<std::is_integral<std::decay_t<T>>::value &&
                                           std::is_signed<std::decay_t<T>>::value, int> = 0>
    inline void print( T num ) {
+#ifdef EOSIO_PRINT_BUFFER
+      if constexpr(std::is_same<T, int128_t>::value) {
+        print_buffer::flush();
+        internal_use_do_not_use::printi128(&num);
+      } else if constexpr(std::is_same<T, char>::value)
+        print_buffer::write(num);
+      else
+        print_buffer::write_int(num);
+#else
       if constexpr(std::is_same<T, int128_t>::value)
         internal_use_do_not_use::printi128(&num);
       else if constexpr(std::is_same<T, char>::value)
         internal_use_do_not_use::prints_l( &num, 1 );
       else
         internal_use_do_not_use::printi(num);
+#endif
    }
 
    /**
@@ -123,12 +225,22 @@ namespace eosio {
    template <typename T, std::enable_if_t<std::is_integral<std::decay_t<T>>::value &&
                                           !std::is_signed<std::decay_t<T>>::value, int> = 0>
    inline void print( T num ) {
+#ifdef EOSIO_PRINT_BUFFER
+      if constexpr(std::is_same<T, uint128_t>::value) {
+         print_buffer::flush();
+         internal_use_do_not_use::printui128(&num);
+      } else if constexpr(std::is_same<T, bool>::value)
+         print(num?"true":"false");
+      else
+        print_buffer::write_uint(num);
+#else
       if constexpr(std::is_same<T, uint128_t>::value)
          internal_use_do_not_use::printui128(&num);
       else if constexpr(std::is_same<T, bool>::value)
          internal_use_do_not_use::prints(num?"true":"false");
       else
         internal_use_do_not_use::printui(num);
+#endif
    }
 
    /**
@@ -137,7 +249,12 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( float num ) { internal_use_do_not_use::printsf( num ); }
+   inline void print( float num ) {
+#ifdef EOSIO_PRINT_BUFFER
+      print_buffer::flush();
+#endif
+      internal_use_do_not_use::printsf( num );
+   }
 
    /**
     *  Prints double-precision floating point number (i.e. double)
@@ -145,7 +262,12 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( double num ) { internal_use_do_not_use::printdf( num ); }
+   inline void print( double num ) {
+#ifdef EOSIO_PRINT_BUFFER
+      print_buffer::flush();
+#endif
+      internal_use_do_not_use::printdf( num );
+   }
 
    /**
     *  Prints quadruple-precision floating point number (i.e. long double)
@@ -153,7 +275,12 @@ namespace eosio {
     *  @ingroup console
     *  @param num to be printed
     */
-   inline void print( long double num ) { internal_use_do_not_use::printqf( &num ); }
+   inline void print( long double num ) {
+#ifdef EOSIO_PRINT_BUFFER
+      print_buffer::flush();
+#endif
+      internal_use_do_not_use::printqf( &num );
+   }
 
   /**
     *  Prints class object
@@ -165,9 +292,9 @@ namespace eosio {
    template<typename T, std::enable_if_t<!std::is_integral<std::decay_t<T>>::value, int> = 0>
    inline void print( T&& t ) {
       if constexpr (std::is_same<std::decay_t<T>, std::string>::value)
-         internal_use_do_not_use::prints_l( t.c_str(), t.size() );
+         printl( t.c_str(), t.size() );
       else if constexpr (std::is_same<std::decay_t<T>, char*>::value)
-         internal_use_do_not_use::prints(t);
+         print( static_cast<const char*>(t) );
       else
          t.print();
    }
@@ -179,7 +306,7 @@ namespace eosio {
     *  @param s null terminated string to be printed
     */
    inline void print_f( const char* s ) {
-     internal_use_do_not_use::prints(s);
+     print(s);
    }
 
    /**
@@ -204,7 +331,7 @@ namespace eosio {
             print_f( s+1, rest... );
             return;
          }
-         internal_use_do_not_use::prints_l( s, 1 );
+         printl( s, 1 );
          s++;
       }
    }
@@ -0,0 +1,70 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace eosio {
+   namespace internal_use_do_not_use {
+      /**
+       * Buffer which host functions copy rows, actions and other data into. It starts inline and grows
+       * geometrically, so when it is reused for every read, most reads fit and are done with a single host call.
+       */
+      class read_buffer {
+         public:
+            constexpr static size_t initial_capacity = 512;
+
+            read_buffer() = default;
+
+            ~read_buffer() {
+               if( _data != _inline_data )
+                  free( _data );
+            }
+
+            read_buffer( const read_buffer& ) = delete;
+            read_buffer& operator=( const read_buffer& ) = delete;
+
+            char*  data()const     { return _data; }
+            size_t capacity()const { return _capacity; }
+
+            // grows to more than `n` bytes, so that what was just read fits without filling the buffer
+            void reserve( size_t n ) {
+               size_t capacity = _capacity;
+               while( capacity <= n )
+                  capacity *= 2;
+               if( _data != _inline_data )
+                  free( _data );
+               _data     = static_cast<char*>( malloc( capacity ) );
+               _capacity = capacity;
+            }
+
+            /**
+             * Reads with a host function which returns how much it copied, and the full size when it is given an
+             * empty buffer, such as db_get_i64 or get_context_free_data.
+             *
+             * @param read_into - calls the host function with a buffer and its size
+             * @return the size read, or the negative result of the host function
+             */
+            template<typename ReadInto>
+            int read( ReadInto&& read_into ) {
+               int size = read_into( _data, _capacity );
+               if( size >= 0 && size_t(size) == _capacity ) {
+                  size = read_into( nullptr, 0 );
+                  if( size_t(size) > _capacity ) {
+                     reserve( size_t(size) );
+                     read_into( _data, size_t(size) );
+                  }
+               }
+               return size;
+            }
+
+         private:
+            char   _inline_data[initial_capacity];
+            char*  _data     = _inline_data;
+            size_t _capacity = initial_capacity;
+      };
+   }
+}
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <variant>
-#include <set>
-#include <stack>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <string_view>
+#include <utility>
 #include "check.hpp"
 #include "print.hpp"
 
@@ -12,180 +14,293 @@ namespace eosio {
    template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
    namespace impl {
-      struct str_t;
-      struct concat_t;
-      typedef std::variant<concat_t, str_t> rope_node;
-
-      struct str_t {
-         const char*              c_str;
-         size_t                   size;
-         mutable const rope_node* temp = nullptr;
+      /**
+       * A piece of a rope, either referencing memory the rope doesn't own or holding the characters
+       * inline in the arena right after the leaf, with room for more short appends
+       */
+      struct rope_leaf {
+         rope_leaf*  next     = nullptr;
+         const char* data     = nullptr;
+         size_t      size     = 0;
+         size_t      capacity = 0;
+         bool        owned    = false;
+
+         char* inline_data() { return reinterpret_cast<char*>(this + 1); }
       };
-      
-      struct concat_t {
-         rope_node*               left      = nullptr;
-         rope_node*               right     = nullptr;
-         mutable const rope_node* temp      = nullptr;
-         mutable bool             temp_left = false;
+
+      /**
+       * Bump allocator for the leaves and buffers of a rope, everything is freed at once when the arena
+       * is destroyed
+       */
+      class rope_arena {
+         private:
+            struct block {
+               block* next;
+               size_t capacity;
+               size_t used;
+            };
+            block* blocks = nullptr;
+
+         public:
+            static constexpr size_t min_block_size = 512;
+            static constexpr size_t max_block_size = 64*1024;
+
+            rope_arena() = default;
+            rope_arena(const rope_arena&) = delete;
+            rope_arena& operator=(const rope_arena&) = delete;
+            rope_arena(rope_arena&& a) : blocks(a.blocks) { a.blocks = nullptr; }
+            rope_arena& operator=(rope_arena&& a) {
+               std::swap(blocks, a.blocks);
+               return *this;
+            }
+            ~rope_arena() {
+               while (blocks) {
+                  block* next = blocks->next;
+                  free(blocks);
+                  blocks = next;
+               }
+            }
+
+            void* allocate(size_t n) {
+               n = (n + alignof(rope_leaf) - 1) & ~(alignof(rope_leaf) - 1);
+               if (!blocks || blocks->capacity - blocks->used < n) {
+                  size_t capacity = std::max(n, blocks ? std::min(blocks->capacity * 2, max_block_size) : min_block_size);
+                  block* b = static_cast<block*>(malloc(sizeof(block) + capacity));
+                  eosio::check(b != nullptr, "rope: out of memory");
+                  *b = block{blocks, capacity, 0};
+                  blocks = b;
+               }
+               void* ret = reinterpret_cast<char*>(blocks + 1) + blocks->used;
+               blocks->used += n;
+               return ret;
+            }
+
+            /// take over the blocks of another arena, the current block stays the one allocated from
+            void adopt(rope_arena&& a) {
+               if (!a.blocks)
+                  return;
+               if (!blocks) {
+                  std::swap(blocks, a.blocks);
+                  return;
+               }
+               block* last = a.blocks;
+               while (last->next)
+                  last = last->next;
+               last->next = blocks->next;
+               blocks->next = a.blocks;
+               a.blocks = nullptr;
+            }
       };
    }
 
-   using namespace impl;
+   /**
+    * String built by appending, without copying the appended strings.
+    *
+    * Strings longer than `small_string_size` are referenced and must outlive the rope, shorter ones are
+    * copied into leaves that hold up to `leaf_capacity` characters inline. Leaves are allocated from an
+    * arena which is released in bulk when the rope is destroyed.
+    */
    class rope {
       private:
-         rope_node* root = nullptr;
-         rope_node* last = nullptr;
-         size_t size     = 0;
-         
+         mutable impl::rope_arena arena;
+         impl::rope_leaf*         head = nullptr;
+         impl::rope_leaf*         tail = nullptr;
+         size_t                   size = 0;
+
+         // flattened contents, valid up to `flat_size` and extended in place while it has room
+         mutable char*                  flat           = nullptr;
+         mutable size_t                 flat_size      = 0;
+         mutable size_t                 flat_capacity  = 0;
+         mutable const impl::rope_leaf* flat_last      = nullptr;
+         mutable size_t                 flat_last_size = 0;
+
          static constexpr size_t strlen(const char* str) {
             int i=0;
             while (str[i++]);
             return i;
          }
-         
-         static void c_str(char* buffer, const rope_node* r, size_t& off) {
-            bool going_down = true;
-            if (r) {
-               std::visit([](const auto& n) {
-                  n.temp = nullptr;
-               }, *r);
-            }
-            while (r) {
-               if (going_down) {
-                  std::visit(overloaded {
-                     [&](const concat_t& c) {
-                        if (c.left) {
-                           c.temp_left = true;
-                           std::visit([&](const auto& n){
-                              n.temp = r;
-                           }, *c.left);
-                           going_down = true;
-                           r = c.left;
-                        } else if (c.right) {
-                           c.temp_left = false;
-                           std::visit([&](const auto& n){
-                              n.temp = r;
-                           }, *c.right);
-                           going_down = true;
-                           r = c.right;
-                        } else {
-                           going_down = false;
-                           r = c.temp;
-                        }
-                     },
-                     [&](const str_t& s) { 
-                        off -= s.size;
-                        memcpy(buffer+off, s.c_str, s.size);
-                        going_down = false;
-                        r = s.temp;
-                     }
-                  }, *r);
-               } else {
-                  const auto& c = std::get<concat_t>(*r);
-                  if (c.temp_left && c.right) {
-                     c.temp_left = false;
-                     std::visit([&](const auto& n){
-                        n.temp = r;
-                     }, *c.right);
-                     going_down = true;
-                     r = c.right;
-                  } else {
-                     going_down = false;
-                     r = c.temp;
-                  }
-               }
+
+         impl::rope_leaf* new_leaf(const char* s, size_t len, size_t capacity, bool owned) {
+            auto leaf = new (arena.allocate(sizeof(impl::rope_leaf) + capacity)) impl::rope_leaf{nullptr, s, len, capacity, owned};
+            if (capacity) {
+               memcpy(leaf->inline_data(), s, len);
+               leaf->data = leaf->inline_data();
             }
+            if (tail)
+               tail->next = leaf;
+            else
+               head = leaf;
+            tail = leaf;
+            return leaf;
          }
 
-         void append(rope_node* rn, bool use_left=false) {
-            auto cc = std::get_if<concat_t>(rn);
-            eosio::check(cc, "append should only allow concat nodes");
-            if (use_left)
-               root = new rope_node(concat_t{rn, root});
-            else {
-               cc->right = root;
-               root = rn;
+         void append_copy(const char* s, size_t len) {
+            if (tail && tail->capacity && tail->capacity - tail->size >= len) {
+               memcpy(tail->inline_data() + tail->size, s, len);
+               tail->size += len;
+            } else {
+               new_leaf(s, len, std::max(len, leaf_capacity), true);
             }
          }
 
-         void at(char& ret, size_t index, rope_node* rn, size_t& index_so_far, bool& stop) {
-            if (rn) {
-               std::visit(overloaded {
-                  [&](const concat_t& c) {
-                     if (!stop) {
-                        if (c.left)
-                           at(ret, index, c.left, index_so_far, stop);
-                        if (c.right)
-                           at(ret, index, c.right, index_so_far, stop);
-                     }
-                  },
-                  [&](const str_t& s) { 
-                     index_so_far -= s.size;
-                     if (index >= index_so_far) {
-                        ret = s.c_str[index-index_so_far];
-                        stop = true;
-                     }
-                  }
-               }, *rn);
+         void clear() {
+            head = tail = nullptr;
+            size = 0;
+            flat = nullptr;
+            flat_size = flat_capacity = flat_last_size = 0;
+            flat_last = nullptr;
+         }
+
+         void flatten()const {
+            if (flat && flat_size == size)
+               return;
+            const impl::rope_leaf* leaf = head;
+            size_t skip = 0;
+            if (flat && size < flat_capacity) {
+               // only the characters appended since the last flatten are copied
+               leaf = flat_last;
+               skip = flat_last_size;
+            } else {
+               flat_capacity = size * 2 + 1;
+               flat = static_cast<char*>(arena.allocate(flat_capacity));
+               flat_size = 0;
+            }
+            for (; leaf; leaf = leaf->next) {
+               memcpy(flat + flat_size, leaf->data + skip, leaf->size - skip);
+               flat_size += leaf->size - skip;
+               skip = 0;
+               flat_last = leaf;
+               flat_last_size = leaf->size;
             }
+            flat[flat_size] = '\0';
          }
 
       public:
+         /// appends of at most this many characters are copied into the rope
+         static constexpr size_t small_string_size = 32;
+         /// characters held inline by a leaf of copied appends
+         static constexpr size_t leaf_capacity = 64;
+
          rope(const char* s) {
-            root = new rope_node(concat_t{new rope_node(str_t{s,strlen(s)-1}), nullptr});
-            last = root;
-            size += strlen(s)-1;
+            append(s, strlen(s)-1);
          }
 
          rope(std::string_view s = "") {
-            root = new rope_node(concat_t{new rope_node(str_t{s.begin(),s.size()}), nullptr});
-            size += s.size();
+            append(s.data(), s.size());
          }
 
-         template <size_t N> 
-         inline constexpr void append(const char (&s)[N]) {
-            append(s, N);
+         rope(const rope& r) {
+            append(r);
+         }
+
+         rope(rope&& r) {
+            *this = std::move(r);
+         }
+
+         rope& operator=(const rope& r) {
+            if (this != &r) {
+               rope tmp(r);
+               *this = std::move(tmp);
+            }
+            return *this;
+         }
+
+         rope& operator=(rope&& r) {
+            if (this != &r) {
+               arena          = std::move(r.arena);
+               head           = r.head;
+               tail           = r.tail;
+               size           = r.size;
+               flat           = r.flat;
+               flat_size      = r.flat_size;
+               flat_capacity  = r.flat_capacity;
+               flat_last      = r.flat_last;
+               flat_last_size = r.flat_last_size;
+               r.clear();
+            }
+            return *this;
+         }
+
+         template <size_t N>
+         inline void append(const char (&s)[N]) {
+            append(s, N-1);
          }
 
          void append(const char* s, size_t len) {
-            str_t _s{s, len};
-            rope_node* rn = new rope_node(concat_t{new rope_node(_s), nullptr});
-            append(rn);
+            if (len == 0)
+               return;
+            if (len <= small_string_size)
+               append_copy(s, len);
+            else
+               new_leaf(s, len, 0, false);
             size += len;
          }
-         
-         constexpr char at(size_t index) {
-            char ret = '\0';
-            size_t sz = size;
-            bool stop = false;
-            at(ret, index, root, sz, stop);
-            return ret;
+
+         char at(size_t index)const {
+            if (index >= size)
+               return '\0';
+            if (flat && index < flat_size)
+               return flat[index];
+            for (auto leaf = head; leaf; leaf = leaf->next) {
+               if (index < leaf->size)
+                  return leaf->data[index];
+               index -= leaf->size;
+            }
+            return '\0';
          }
 
-         constexpr void append(const rope& r) {
-            append(r.root, true);
+         void append(const rope& r) {
+            if (this == &r) {
+               // our own leaves live as long as we do, so they are referenced rather than copied
+               const impl::rope_leaf* last = tail;
+               for (auto leaf = head; leaf; leaf = leaf->next) {
+                  new_leaf(leaf->data, leaf->size, 0, leaf->owned);
+                  if (leaf == last)
+                     break;
+               }
+               size *= 2;
+               return;
+            }
+            for (auto leaf = r.head; leaf; leaf = leaf->next) {
+               if (leaf->owned)
+                  append_copy(leaf->data, leaf->size);
+               else
+                  new_leaf(leaf->data, leaf->size, 0, false);
+            }
             size += r.size;
          }
-        
-         constexpr void append(rope&& r) {
-            append(r.root, true);
+
+         void append(rope&& r) {
+            if (this == &r) {
+               append(static_cast<const rope&>(r));
+               return;
+            }
+            if (!r.head)
+               return;
+            arena.adopt(std::move(r.arena));
+            if (tail)
+               tail->next = r.head;
+            else
+               head = r.head;
+            tail = r.tail;
             size += r.size;
+            r.clear();
          }
 
-         constexpr char operator[](size_t index) {
+         char operator[](size_t index)const {
             return at(index);
          }
 
-         constexpr rope& operator+= (const char* s) {
+         rope& operator+= (const char* s) {
             append(s, strlen(s)-1);
             return *this;
          }
 
-         constexpr rope& operator+= (const rope& r) {
+         rope& operator+= (const rope& r) {
             append(r);
             return *this;
          }
-         constexpr rope& operator+= (rope&& r) {
+         rope& operator+= (rope&& r) {
             append(std::move(r));
             return *this;
          }
@@ -198,30 +313,28 @@ namespace eosio {
          friend rope operator+ (rope lhs, const rope& rhs) {
             lhs += rhs;
             return lhs;
-         } 
+         }
 
          friend rope operator+ (rope lhs, rope&& rhs) {
             lhs += std::move(rhs);
             return lhs;
-         } 
-         
-         
-         constexpr size_t length() {
+         }
+
+         size_t length()const {
             return size;
          }
-         
+
          void print()const {
-            eosio::print(c_str());
+            eosio::printl(c_str(), size);
          }
-         
+
+         /**
+          * The contents as a null terminated string. The buffer is owned by the rope and stays valid until
+          * the rope is destroyed, flattening again after more appends only copies the new characters.
+          */
          char* c_str()const {
-            char* ret = new char[size+1];
-            if (root) {
-               size_t off = size;
-               c_str(ret, root, off);
-            }
-            ret[size] = '\0';
-            return ret;
+            flatten();
+            return flat;
          }
 
          std::string_view sv()const {
@@ -6,96 +6,88 @@
 #pragma once
 
 #include <cstring>   // memcpy, memset, strlen
-#include <algorithm> // std::swap
-#include <memory>    // std::unique_ptr
-#include <variant>   // std::variant
-#include <vector>    // std::vector
+#include <algorithm> // std::min, std::max, std::swap
 
 #include "datastream.hpp" // eosio::datastream
+#include "print.hpp"      // eosio::printl
 #include "varint.hpp"     // eosio::unsigned_int
 
 namespace eosio {
 
+   /**
+    * String type for contracts.
+    *
+    * Strings of up to `sso_capacity` characters are stored inline, longer ones on the heap with a capacity
+    * that doubles as they grow. A string constructed from a literal that is too long to be stored inline
+    * references the literal until it is modified.
+    */
    class string {
    public:
       static constexpr size_t npos = -1;
 
+      /// number of characters stored without allocating
+      static constexpr size_t sso_capacity = 23;
+
       template <size_t N>
-      constexpr string(const char (&str)[N])
-         : _size{N-1}
-         , _capacity{_size}
-         , _begin{str}
-      {
-      }
-
-      constexpr string()
-         : _size{0}
-         , _capacity{0}
-         , _begin{""}
-      {
-      }
-
-      constexpr string(const char* str, const size_t n)
-         : _size{n}
-         , _capacity{_size*2}
-      {
-         char* begin{new char[_capacity]};
-         memcpy(begin, str, _size);
-         _begin = begin;
-      }
-
-      constexpr string(const size_t n, const char c)
-         : _size{n}
-         , _capacity{_size*2}
-      {
-         char* begin{new char[_capacity]};
-         memset(begin, c, _size);
-         _begin = begin;
-      }
-
-      constexpr string(const string& str, const size_t pos, const size_t n)
-         : _size{n}
-         , _capacity{_size*2}
-      {
-         if (n == string::npos || str._size < pos+n) {
-            _size     = str._size;
-            _capacity = _size*2;
+      string(const char (&str)[N]) {
+         if (N-1 <= sso_capacity) {
+            assign(str, N-1);
+         } else {
+            _data     = const_cast<char*>(str);
+            _size     = N-1;
+            _capacity = 0;
          }
+      }
+
+      string() {
+      }
 
-         clone(_size, _capacity, str.data()+pos);
+      string(const char* str, const size_t n) {
+         assign(str, n);
       }
 
-      constexpr string(const string& str)
-         : _size{str._size}
-         , _capacity{str._capacity}
-      {
-         if (str.is_literal())
-            _begin = std::get<const char*>(str._begin);
-         else
-            clone(str._size, str._capacity, str.data());
+      string(const size_t n, const char c) {
+         reserve(n);
+         memset(_data, c, n);
+         set_size(n);
       }
 
-      constexpr string(string&& str)
-         : _size{str._size}
-         , _capacity{str._capacity}
-      {
-         if (str.is_literal())
-            _begin = std::get<const char*>(str._begin);
-         else
-            _begin = std::move(std::get<uptr>(str._begin));
+      string(const string& str, const size_t pos, const size_t n) {
+         eosio::check(pos <= str._size, "eosio::string::substr");
+         assign(str._data+pos, std::min(n, str._size-pos));
+      }
+
+      string(const string& str) {
+         if (str.is_literal()) {
+            _data     = str._data;
+            _size     = str._size;
+            _capacity = 0;
+         } else {
+            assign(str._data, str._size);
+         }
+      }
+
+      string(string&& str) {
+         steal(str);
+      }
+
+      ~string() {
+         if (is_heap())
+            delete[] _data;
       }
 
       string& operator=(const string& str) {
          if (&str == this)
             return *this;
 
-         _size     = str._size;
-         _capacity = str._capacity;
-
-         if (str.is_literal())
-            _begin = std::get<const char*>(str._begin);
-         else
-            clone(_size, _capacity, str.data());
+         if (str.is_literal()) {
+            release();
+            _data     = str._data;
+            _size     = str._size;
+            _capacity = 0;
+         } else {
+            assign(str._data, str._size);
+         }
 
          return *this;
       }
@@ -104,33 +96,23 @@ namespace eosio {
          if (&str == this)
             return *this;
 
-         _size     = str._size;
-         _capacity = str._capacity;
-
-         if (str.is_literal())
-            _begin = std::get<const char*>(str._begin);
-         else
-            _begin = std::move(std::get<uptr>(str._begin));
+         release();
+         steal(str);
 
          return *this;
       }
 
       string& operator=(const char* str) {
-         _size     = strlen(str);
-         _capacity = _size;
-         _begin    = str;
-
+         assign(str, strlen(str));
          return *this;
       }
 
       char& operator[](const size_t n) {
-         if (is_literal())
-            clone(_size, _capacity, std::get<const char*>(_begin));
-         return std::get<uptr>(_begin).get()[n];
+         return begin()[n];
       }
 
       const char operator[](const size_t n) const {
-         return (is_literal()) ? std::get<const char*>(_begin)[n] : std::get<uptr>(_begin).get()[n];
+         return _data[n];
       }
 
       char& at(const size_t n) {
@@ -164,42 +146,21 @@ namespace eosio {
       }
 
       const char* data() const {
-         return cbegin();
+         return _data;
       }
 
       const char* c_str() const {
-         static size_t prev_size{0};
-         char* raw_ptr{nullptr};
-         
-         if (is_literal())
-            return std::get<const char*>(_begin);
-         
-         if (_size == prev_size)
-            return std::get<uptr>(_begin).get();
-         else if (_size < prev_size)
-            raw_ptr = std::get<uptr>(_begin).get();
-         else {
-            uptr tmp  = std::make_unique<char[]>(_size+1);
-            raw_ptr   = tmp.get();
-            prev_size = _size;
-            memcpy(raw_ptr, std::get<uptr>(_begin).get(), _size);
-         }
-         
-         raw_ptr[_size+1] = '\0';
-         return raw_ptr;
+         return _data;
       }
 
       char* begin() {
-         if (is_literal()) {
-            _capacity *= 2;
-            clone(_size, _capacity, std::get<const char*>(_begin));
-         }
-
-         return std::get<uptr>(_begin).get();
+         if (is_literal())
+            grow(_size);
+         return _data;
       }
 
       const char* cbegin() const {
-         return (is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get();
+         return _data;
       }
 
       char* end() {
@@ -207,7 +168,7 @@ namespace eosio {
       }
 
       const char* cend() const {
-         return cbegin()+_size;
+         return _data+_size;
       }
 
       bool empty() const {
@@ -223,7 +184,9 @@ namespace eosio {
       }
 
       size_t capacity() const {
-         return _capacity;
+         if (is_small())
+            return sso_capacity;
+         return is_literal() ? _size : _capacity;
       }
 
       size_t max_size() const {
@@ -231,40 +194,40 @@ namespace eosio {
       }
 
       void reserve(const size_t n) {
-         if (_capacity < n) {
-            _capacity = n;
-
-            const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
-            clone(_size, _capacity, tmp);
-         }
-         else
-            return;
+         if (capacity() < n)
+            grow(n);
       }
 
       void shrink_to_fit() {
-         _capacity = _size;
+         if (!is_heap() || _capacity == _size)
+            return;
+         char* old = _data;
+         if (_size <= sso_capacity) {
+            _data = _small;
+            memcpy(_data, old, _size+1);
+            _capacity = 0;
+         } else {
+            _data = new char[_size+1];
+            memcpy(_data, old, _size+1);
+            _capacity = _size;
+         }
+         delete[] old;
       }
 
       void clear() {
-         _size = 0;
-
          if (is_literal())
-            clone(_size, _capacity, std::get<const char*>(_begin));
-         std::get<uptr>(_begin).get()[0] = '\0';
+            _data = _small;
+         set_size(0);
       }
 
       void resize(const size_t n) {
-         if (is_literal())
-            clone(n, _capacity, std::get<const char*>(_begin));
-         else {
-            _size = n;
-            if (n <= _capacity)
-               memset(std::get<uptr>(_begin).get()+_size, '\0', _capacity-_size);
-            else {
-               _capacity = _size*2;
-               clone(_size, _capacity, std::get<uptr>(_begin).get());
-            }
+         if (n > _size) {
+            reserve_for(n);
+            memset(_data+_size, '\0', n-_size);
+         } else if (is_literal()) {
+            grow(_size);
          }
+         set_size(n);
       }
 
       void swap(string& str) {
@@ -278,7 +241,7 @@ namespace eosio {
       void pop_back() {
          if (_size == 0)
             return;
-         resize(--_size);
+         resize(_size-1);
       }
 
       string substr(size_t pos = 0, size_t len = npos) const {
@@ -289,8 +252,7 @@ namespace eosio {
          eosio::check(pos <= _size, "eosio::string::copy");
          len = (_size < pos+len) ? _size : len;
 
-         const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
-         memcpy(s, tmp+pos, len);
+         memcpy(s, _data+pos, len);
 
          return (_size < pos+len) ? _size-pos : len;
       }
@@ -302,79 +264,55 @@ namespace eosio {
       string& insert(const size_t pos, const char* str, const size_t len) {
          eosio::check((str != nullptr) && (0 <= pos && pos <= _size), "eosio::string::insert");
 
-         if (_capacity < (_size+len)) {
-            _size      += len;
-            _capacity  = _size*2;
-
-            uptr begin{std::make_unique<char[]>(_capacity)};
-            const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
-
-            memcpy(begin.get(), tmp, pos);
-            memcpy(begin.get()+pos, str, len);
-            memcpy(begin.get()+len+pos, tmp+pos, _size-len-pos);
-
-            _begin = std::move(begin);
-         }
-         else {
-            if(is_literal())
-               clone(_size, _capacity, std::get<const char*>(_begin));
-            _size += len;
-            memmove(std::get<uptr>(_begin).get()+pos+len, std::get<uptr>(_begin).get()+pos, _size-pos);
-            memcpy(std::get<uptr>(_begin).get()+pos, str, len);
+         if (str >= _data && str <= _data+_size) {
+            // inserting a part of this string
+            const string tmp(str, len);
+            return insert(pos, tmp._data, len);
          }
 
+         reserve_for(_size+len);
+         memmove(_data+pos+len, _data+pos, _size-pos);
+         memcpy(_data+pos, str, len);
+         set_size(_size+len);
+
          return *this;
       }
 
       string& insert(const size_t pos, const string& str) {
-         insert(pos, str.c_str());
-         return *this;
+         return insert(pos, str._data, str._size);
       }
 
       string& erase(size_t pos = 0, size_t len = npos) {
          eosio::check(0 <= pos && pos <= _size, "eosio::string::erase");
 
-         if (len == string::npos)
-            len = _size-pos;
+         len = std::min(len, _size-pos);
+         if (len == 0)
+            return *this;
 
-         _size -= len;
-
-         if (is_literal())
-            clone(_size, _capacity, std::get<const char*>(_begin));
-         memmove(std::get<uptr>(_begin).get()+pos+len, std::get<uptr>(_begin).get(), len);
-         resize(_size);
+         begin();
+         memmove(_data+pos, _data+pos+len, _size-pos-len);
+         set_size(_size-len);
 
          return *this;
       }
 
       string& append(const char* str) {
          eosio::check(str != nullptr, "eosio::string::append");
-         insert(_size, str);
+         return append(str, strlen(str));
+      }
 
-         return *this;
+      string& append(const char* str, const size_t len) {
+         return insert(_size, str, len);
       }
 
       string& append(const string& str) {
-         insert(_size, str);
-         return *this;
+         return insert(_size, str);
       }
 
       string& operator+=(const char c) {
-         if (_capacity == 0) {
-            _size     = 1;
-            _capacity = 2;
-            clone(1, _capacity, &c);
-         }
-         else if (_size == _capacity) {
-            _capacity = ++_size*2;
-
-            const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
-            clone(_size, _capacity, tmp);
-            std::get<uptr>(_begin).get()[_size-1] = c;
-         }
-         else
-            std::get<uptr>(_begin).get()[_size++] = c;
-
+         reserve_for(_size+1);
+         _data[_size] = c;
+         set_size(_size+1);
          return *this;
       }
 
@@ -389,8 +327,7 @@ namespace eosio {
       }
 
       inline void print() const {
-         const char* tmp{(is_literal()) ? std::get<const char*>(_begin) : std::get<uptr>(_begin).get()};
-         internal_use_do_not_use::prints_l(tmp, _size);
+         printl(_data, _size);
       }
 
       friend bool operator< (const string& lhs, const string& rhs);
@@ -402,64 +339,127 @@ namespace eosio {
 
       friend string operator+ (const string& lhs, const string& rhs);
 
+      template<typename DataStream>
+      friend DataStream& operator>>(DataStream& ds, string& str);
+
    private:
-      using uptr    = std::unique_ptr<char[]>;
-      using sso_str = std::variant<const char*, uptr>;
+      // `_data` points to `_small`, to a heap buffer of `_capacity`+1 characters, or to a literal when
+      // `_capacity` is 0. Owned buffers are always null terminated.
+      char*  _data     = _small;
+      size_t _size     = 0;
+      size_t _capacity = 0;
+      char   _small[sso_capacity+1] = {};
 
-      size_t  _size     = 0;
-      size_t  _capacity = 0;
-      sso_str _begin    = nullptr;
+      bool is_small() const {
+         return _data == _small;
+      }
 
-      void clone(size_t size, size_t capacity, const char* str) {
-         _size     = size;
-         _capacity = capacity;
+      bool is_heap() const {
+         return !is_small() && _capacity != 0;
+      }
 
-         uptr begin{std::make_unique<char[]>(capacity)};
-         memcpy(begin.get(), str, size);
-         _begin = std::move(begin);
+      bool is_literal() const {
+         return !is_small() && _capacity == 0;
       }
 
-      constexpr bool is_literal() const {
-         return (std::holds_alternative<const char*>(_begin)) ? true : false;
+      void set_size(size_t n) {
+         _size = n;
+         _data[n] = '\0';
+      }
+
+      // moves the contents to an owned buffer of at least `n` characters
+      void grow(size_t n) {
+         char* old = _data;
+         const bool heap = is_heap();
+         if (n <= sso_capacity) {
+            _data = _small;
+            _capacity = 0;
+         } else {
+            _data = new char[n+1];
+            _capacity = n;
+         }
+         if (old != _data)
+            memcpy(_data, old, _size);
+         _data[_size] = '\0';
+         if (heap && old != _data)
+            delete[] old;
+      }
+
+      // makes room for `n` characters, doubling the capacity when it has to grow
+      void reserve_for(size_t n) {
+         if (is_literal())
+            grow(std::max(n, _size*2));
+         else if (n > capacity())
+            grow(std::max(n, capacity()*2));
+      }
+
+      void assign(const char* str, size_t n) {
+         if (is_literal())
+            _data = _small;
+         if (n > capacity()) {
+            release();
+            grow(n);
+         }
+         memmove(_data, str, n);
+         set_size(n);
       }
-   };
 
-   bool operator< (const string& lhs, const string& rhs) {
-      const char* beg_lhs{lhs.cbegin()}; const char* end_lhs{lhs.cend()};
-      const char* beg_rhs{rhs.cbegin()}; const char* end_rhs{rhs.cend()};
+      void release() {
+         if (is_heap())
+            delete[] _data;
+         _data     = _small;
+         _size     = 0;
+         _capacity = 0;
+         _small[0] = '\0';
+      }
 
-      for(; beg_lhs != end_lhs && beg_rhs != end_rhs; ++beg_lhs, ++beg_rhs) {
-         if (*beg_lhs < *beg_rhs)
-            return true;
-         if (*beg_rhs < *beg_lhs)
-            return false;
+      void steal(string& str) {
+         _size     = str._size;
+         _capacity = str._capacity;
+         if (str.is_small()) {
+            _data = _small;
+            memcpy(_small, str._small, str._size+1);
+         } else {
+            _data = str._data;
+            if (str.is_heap()) {
+               str._data     = str._small;
+               str._size     = 0;
+               str._capacity = 0;
+               str._small[0] = '\0';
+            }
+         }
       }
+   };
 
-      return beg_lhs == end_lhs && beg_rhs != end_rhs;
+   inline bool operator< (const string& lhs, const string& rhs) {
+      const int cmp = memcmp(lhs._data, rhs._data, std::min(lhs._size, rhs._size));
+      return cmp < 0 || (cmp == 0 && lhs._size < rhs._size);
    }
 
-   bool operator> (const string& lhs, const string& rhs) {
+   inline bool operator> (const string& lhs, const string& rhs) {
       return (rhs < lhs);
    }
 
-   bool operator<=(const string& lhs, const string& rhs) {
+   inline bool operator<=(const string& lhs, const string& rhs) {
       return !(rhs < lhs);
    }
 
-   bool operator>=(const string& lhs, const string& rhs) {
+   inline bool operator>=(const string& lhs, const string& rhs) {
       return !(lhs < rhs);
    }
 
-   bool operator==(const string& lhs, const string& rhs) {
-      return !(lhs < rhs) && !(rhs < lhs);
+   inline bool operator==(const string& lhs, const string& rhs) {
+      return lhs._size == rhs._size && memcmp(lhs._data, rhs._data, lhs._size) == 0;
    }
 
-   bool operator!=(const string& lhs, const string& rhs) {
+   inline bool operator!=(const string& lhs, const string& rhs) {
       return !(lhs == rhs);
    }
 
-   string operator+(const string& lhs, const string& rhs) {
-      string res{lhs};
+   inline string operator+(const string& lhs, const string& rhs) {
+      string res;
+      res.reserve(lhs.size() + rhs.size());
+      res += lhs;
       res += rhs;
       return res;
    }
@@ -472,11 +472,15 @@ namespace eosio {
       return ds;
    }
 
+   /// reads the characters straight into the storage of `str`
    template<typename DataStream>
    DataStream& operator>>(DataStream& ds, string& str) {
-      std::vector<char> tmp;
-      ds >> tmp;
-      str = (tmp.size()) ? string(tmp.data(), tmp.size()) : string();
+      unsigned_int size;
+      ds >> size;
+      str.clear();
+      str.reserve(size.value);
+      ds.read(str._data, size.value);
+      str.set_size(size.value);
       return ds;
    }
 
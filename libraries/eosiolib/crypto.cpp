@@ -5,6 +5,8 @@
 #include "core/eosio/crypto.hpp"
 #include "core/eosio/datastream.hpp"
 
+#include <cstdlib>
+
 extern "C" {
    struct __attribute__((aligned (16))) capi_checksum160 { uint8_t hash[20]; };
    struct __attribute__((aligned (16))) capi_checksum256 { uint8_t hash[32]; };
@@ -43,26 +45,56 @@ extern "C" {
 
 }
 
+namespace {
+   /**
+    * Packs a value into an inline buffer, or into the heap when it doesn't fit, so that the common
+    * K1/R1 keys and signatures are passed to the intrinsics without an allocation
+    */
+   template<typename T, size_t N>
+   class stack_packed {
+      public:
+         explicit stack_packed( const T& v ) : _size(eosio::pack_size(v)) {
+            _data = _size <= N ? _buffer : static_cast<char*>(malloc(_size));
+            eosio::datastream<char*> ds( _data, _size );
+            ds << v;
+         }
+         ~stack_packed() {
+            if ( _data != _buffer )
+               free(_data);
+         }
+         stack_packed( const stack_packed& ) = delete;
+         stack_packed& operator=( const stack_packed& ) = delete;
+
+         const char* data()const { return _data; }
+         size_t size()const { return _size; }
+
+      private:
+         size_t _size;
+         char*  _data;
+         char   _buffer[N];
+   };
+
+   // packed K1/R1 signatures are 66 bytes and keys 34 bytes, webauthn ones are usually larger
+   using packed_signature  = stack_packed<eosio::signature, 128>;
+   using packed_public_key = stack_packed<eosio::public_key, 64>;
+}
+
 namespace eosio {
 
    void assert_sha256( const char* data, uint32_t length, const eosio::checksum256& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash_data.data()) );
+      ::assert_sha256( data, length, reinterpret_cast<const ::capi_checksum256*>(hash.bytes()) );
    }
 
    void assert_sha1( const char* data, uint32_t length, const eosio::checksum160& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
+      ::assert_sha1( data, length, reinterpret_cast<const ::capi_checksum160*>(hash.bytes()) );
    }
 
    void assert_sha512( const char* data, uint32_t length, const eosio::checksum512& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash_data.data()) );
+      ::assert_sha512( data, length, reinterpret_cast<const ::capi_checksum512*>(hash.bytes()) );
    }
 
    void assert_ripemd160( const char* data, uint32_t length, const eosio::checksum160& hash ) {
-      auto hash_data = hash.extract_as_byte_array();
-      ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash_data.data()) );
+      ::assert_ripemd160( data, length, reinterpret_cast<const ::capi_checksum160*>(hash.bytes()) );
    }
 
    eosio::checksum256 sha256( const char* data, uint32_t length ) {
@@ -90,12 +122,10 @@ namespace eosio {
    }
 
    eosio::public_key recover_key( const eosio::checksum256& digest, const eosio::signature& sig ) {
-      auto digest_data = digest.extract_as_byte_array();
-
-      auto sig_data = eosio::pack(sig);
+      packed_signature sig_data(sig);
 
       char optimistic_pubkey_data[256];
-      size_t pubkey_size = ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
+      size_t pubkey_size = ::recover_key( reinterpret_cast<const capi_checksum256*>(digest.bytes()),
                                           sig_data.data(), sig_data.size(),
                                           optimistic_pubkey_data, sizeof(optimistic_pubkey_data) );
 
@@ -107,7 +137,7 @@ namespace eosio {
          constexpr static size_t max_stack_buffer_size = 512;
          void* pubkey_data = (max_stack_buffer_size < pubkey_size) ? malloc(pubkey_size) : alloca(pubkey_size);
 
-         ::recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
+         ::recover_key( reinterpret_cast<const capi_checksum256*>(digest.bytes()),
                         sig_data.data(), sig_data.size(),
                         reinterpret_cast<char*>(pubkey_data), pubkey_size );
          eosio::datastream<const char*> pubkey_ds( reinterpret_cast<const char*>(pubkey_data), pubkey_size );
@@ -121,12 +151,10 @@ namespace eosio {
    }
 
    void assert_recover_key( const eosio::checksum256& digest, const eosio::signature& sig, const eosio::public_key& pubkey ) {
-      auto digest_data = digest.extract_as_byte_array();
-
-      auto sig_data = eosio::pack(sig);
-      auto pubkey_data = eosio::pack(pubkey);
+      packed_signature sig_data(sig);
+      packed_public_key pubkey_data(pubkey);
 
-      ::assert_recover_key( reinterpret_cast<const capi_checksum256*>(digest_data.data()),
+      ::assert_recover_key( reinterpret_cast<const capi_checksum256*>(digest.bytes()),
                             sig_data.data(), sig_data.size(),
                             pubkey_data.data(), pubkey_data.size() );
    }
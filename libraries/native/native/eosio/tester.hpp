@@ -10,6 +10,10 @@ extern "C" bool ___has_failed;
 extern "C" bool ___earlier_unit_test_has_failed;
 
 inline void silence_output(bool t) {
+#ifdef EOSIO_PRINT_BUFFER
+   // what was printed so far is shown or not depending on the current setting
+   eosio::print_buffer::flush();
+#endif
    ___disable_output = t;
 }
 inline bool has_failed() {
@@ -130,3 +134,31 @@ inline bool expect_print(bool check, const std::string& li, const char (&expecte
       ___has_failed |= ___earlier_unit_test_has_failed; \
       ___earlier_unit_test_has_failed = ___has_failed; \
    }
+
+/// Keeps the compiler from optimizing away the computation of `v` inside of a benchmark
+template <typename T>
+inline void bench_do_not_optimize(const T& v) {
+   asm volatile("" : : "g"(&v) : "memory");
+}
+
+inline uint64_t bench_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+   return __builtin_ia32_rdtsc();
+#else
+   return __builtin_readcyclecounter();
+#endif
+}
+
+/**
+ * Runs the statements `ITERATIONS` times and prints the average number of cycles of an iteration,
+ * the loop counter is available as `__bench_i`
+ */
+#define EOSIO_BENCH(NAME, ITERATIONS, ...) \
+   { \
+      uint64_t ___bench_start = bench_cycles(); \
+      for (uint64_t __bench_i = 0; __bench_i < (ITERATIONS); __bench_i++) { \
+         __VA_ARGS__ \
+      } \
+      uint64_t ___bench_cycles = (bench_cycles() - ___bench_start) / (ITERATIONS); \
+      eosio::print("bench ", NAME, " : ", ___bench_cycles, " cycles/iter\n"); \
+   }
@@ -0,0 +1,292 @@
+#pragma once
+
+/**
+ * Runtime support for contracts translated by eosio-wasm2native.
+ *
+ * This header is included by the generated `<module>_glue.cpp`, after the wasm2c generated header,
+ * and defines the wasm2c runtime (wasm_rt_*) on top of the native tester.  It must only be included
+ * by that one translation unit.
+ */
+#ifndef WASM_RT_H_
+#error "include the eosio-wasm2native generated header before eosio/wasm2native.hpp"
+#endif
+
+#include <eosio/action.h>
+#include <eosio/chain.h>
+#include <eosio/crypto.h>
+#include <eosio/db.h>
+#include <eosio/permission.h>
+#include <eosio/print.h>
+#include <eosio/privileged.h>
+#include <eosio/system.h>
+#include <eosio/transaction.h>
+#include <eosio/types.h>
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace native { namespace wasm2native {
+   /// linear memory of the translated module, set by start_apply
+   inline wasm_rt_memory_t* memory = nullptr;
+
+   inline uint8_t* memory_ptr(uint32_t offset, uint32_t len = 0) {
+      if (uint64_t(offset) + len > memory->size)
+         eosio_assert(false, "wasm2native: access outside of linear memory");
+      return memory->data + offset;
+   }
+
+   /// size of the object a pointer parameter points to, 1 for the bytes of a `void*` buffer
+   template <typename T>
+   constexpr size_t pointee_size() {
+      using pointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+      if constexpr (std::is_void<pointee>::value)
+         return 1;
+      else
+         return sizeof(pointee);
+   }
+
+   /// size of the null terminated string at offset, including the terminator
+   inline uint64_t string_size(uint32_t offset) {
+      const void* end = offset < memory->size ? memchr(memory->data + offset, 0, memory->size - offset) : nullptr;
+      if (!end)
+         eosio_assert(false, "wasm2native: access outside of linear memory");
+      return static_cast<const uint8_t*>(end) - (memory->data + offset) + 1;
+   }
+
+   /**
+    * Number of bytes of linear memory the pointer parameter I may access, validated like nodeos does
+    * - a buffer of bytes followed by an integer is that many bytes, e.g. `read_action_data(void*, uint32_t)`
+    * - a `char*` without a length is a null terminated string, e.g. `prints(const char*)`
+    * - any other pointer followed by an uint32_t is that many objects, e.g. `db_idx256_store(..., uint128_t*, uint32_t)`
+    * - otherwise a pointer is one object, e.g. the secondary key of `db_idx64_find_primary(..., uint64_t*, uint64_t)`
+    */
+   template <size_t I, typename... Params, typename... WasmArgs>
+   inline uint64_t pointer_size(const std::tuple<WasmArgs...>& args) {
+      using param = std::tuple_element_t<I, std::tuple<Params...>>;
+      constexpr bool has_next = I + 1 < sizeof...(Params);
+      using next = std::tuple_element_t<has_next ? I + 1 : I, std::tuple<Params...>>;
+      using pointee = std::remove_cv_t<std::remove_pointer_t<param>>;
+
+      if constexpr (pointee_size<param>() == 1) {
+         if constexpr (has_next && std::is_integral<next>::value)
+            return std::get<I + 1>(args);
+         else if constexpr (std::is_same<pointee, char>::value)
+            return string_size(std::get<I>(args));
+         else
+            return 1;
+      } else if constexpr (has_next && std::is_same<next, uint32_t>::value) {
+         return uint64_t(std::get<I + 1>(args)) * pointee_size<param>();
+      } else {
+         return pointee_size<param>();
+      }
+   }
+
+   template <typename T, size_t I, typename... Params, typename... WasmArgs>
+   inline auto to_native(const std::tuple<WasmArgs...>& args) -> std::enable_if_t<std::is_pointer<T>::value, T> {
+      const uint64_t size = pointer_size<I, Params...>(args);
+      const uint32_t v    = std::get<I>(args);
+      // contracts pass 0 for `nullptr` along with a 0 length, e.g. when querying the size of a row
+      if (v == 0 && size == 0)
+         return nullptr;
+      if (uint64_t(v) + size > memory->size)
+         eosio_assert(false, "wasm2native: access outside of linear memory");
+      return reinterpret_cast<T>(memory->data + v);
+   }
+
+   template <typename T, size_t I, typename... Params, typename... WasmArgs>
+   inline auto to_native(const std::tuple<WasmArgs...>& args) -> std::enable_if_t<std::is_reference<T>::value, T> {
+      return *reinterpret_cast<std::remove_reference_t<T>*>(memory_ptr(std::get<I>(args), sizeof(std::remove_reference_t<T>)));
+   }
+
+   template <typename T, size_t I, typename... Params, typename... WasmArgs>
+   inline auto to_native(const std::tuple<WasmArgs...>& args) -> std::enable_if_t<std::is_arithmetic<T>::value, T> {
+      return static_cast<T>(std::get<I>(args));
+   }
+
+   template <typename R, typename... Params, typename... WasmArgs, size_t... Is>
+   inline R call(R(*func)(Params...), const std::tuple<WasmArgs...>& args, std::index_sequence<Is...>) {
+      return func(to_native<Params, Is, Params...>(args)...);
+   }
+
+   /**
+    * Call the native definition of an intrinsic with wasm arguments, translating linear memory
+    * offsets into native pointers based on the parameter types of the intrinsic. Every pointer is
+    * validated along with the length that follows it, so that a contract passing a buffer which
+    * doesn't fit in its linear memory traps like on chain instead of corrupting the tester.
+    */
+   template <typename R, typename... Params, typename... WasmArgs>
+   inline R call(R(*func)(Params...), WasmArgs... args) {
+      static_assert(sizeof...(Params) == sizeof...(WasmArgs), "wasm import signature doesn't match the intrinsic");
+      return call(func, std::make_tuple(args...), std::index_sequence_for<Params...>{});
+   }
+
+   [[noreturn]] inline void unsupported(const char* name) {
+      eosio_assert(false, name);
+      __builtin_unreachable();
+   }
+
+   /// imports which nodeos provides itself rather than through an intrinsic in libraries/native
+   namespace builtins {
+      inline unsigned __int128 load128(u64 lo, u64 hi) {
+         return (unsigned __int128)hi << 64 | lo;
+      }
+
+      inline void store128(u32 ret, unsigned __int128 v) {
+         u64 words[2] = { u64(v), u64(v >> 64) };
+         memcpy(memory_ptr(ret, sizeof(words)), words, sizeof(words));
+      }
+
+      inline void __ashlti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+         store128(ret, load128(lo, hi) << (shift & 127));
+      }
+
+      inline void __ashrti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+         store128(ret, __int128(load128(lo, hi)) >> (shift & 127));
+      }
+
+      inline void __lshlti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+         store128(ret, load128(lo, hi) << (shift & 127));
+      }
+
+      inline void __lshrti3(u32 ret, u64 lo, u64 hi, u32 shift) {
+         store128(ret, load128(lo, hi) >> (shift & 127));
+      }
+
+      inline void __divti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+         __int128 rhs = load128(lb, hb);
+         eosio_assert(rhs != 0, "divide by zero");
+         store128(ret, __int128(load128(la, ha)) / rhs);
+      }
+
+      inline void __udivti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+         unsigned __int128 rhs = load128(lb, hb);
+         eosio_assert(rhs != 0, "divide by zero");
+         store128(ret, load128(la, ha) / rhs);
+      }
+
+      inline void __modti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+         __int128 rhs = load128(lb, hb);
+         eosio_assert(rhs != 0, "divide by zero");
+         store128(ret, __int128(load128(la, ha)) % rhs);
+      }
+
+      inline void __umodti3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+         unsigned __int128 rhs = load128(lb, hb);
+         eosio_assert(rhs != 0, "divide by zero");
+         store128(ret, load128(la, ha) % rhs);
+      }
+
+      inline void __multi3(u32 ret, u64 la, u64 ha, u64 lb, u64 hb) {
+         store128(ret, load128(la, ha) * load128(lb, hb));
+      }
+
+      inline u32 memcpy(u32 dst, u32 src, u32 len) {
+         uint8_t* d = memory_ptr(dst, len);
+         const uint8_t* s = memory_ptr(src, len);
+         eosio_assert((d+len <= s || s+len <= d), "memcpy can only accept non-aliasing pointers");
+         ::memcpy(d, s, len);
+         return dst;
+      }
+
+      inline u32 memmove(u32 dst, u32 src, u32 len) {
+         ::memmove(memory_ptr(dst, len), memory_ptr(src, len), len);
+         return dst;
+      }
+
+      inline u32 memcmp(u32 lhs, u32 rhs, u32 len) {
+         int ret = ::memcmp(memory_ptr(lhs, len), memory_ptr(rhs, len), len);
+         return ret < 0 ? -1 : ret > 0 ? 1 : 0;
+      }
+
+      inline u32 memset(u32 dst, u32 val, u32 len) {
+         ::memset(memory_ptr(dst, len), val, len);
+         return dst;
+      }
+
+      inline void abort() {
+         eosio_assert(false, "abort() called");
+      }
+   } // ns eosio::native::wasm2native::builtins
+
+   /**
+    * Reinstantiate the module before each action, the same way nodeos starts every action
+    * with the initial linear memory and globals
+    */
+   inline void start_apply(void (*init)(void), wasm_rt_memory_t** exported_memory) {
+      wasm_rt_call_stack_depth = 0;
+      init();
+      memory = *exported_memory;
+   }
+}}} // ns eosio::native::wasm2native
+
+extern "C" {
+   uint32_t wasm_rt_call_stack_depth;
+
+   void wasm_rt_trap(wasm_rt_trap_t code) {
+      static const char* traps[] = {
+         "wasm trap: none",
+         "wasm trap: out of bounds memory access",
+         "wasm trap: integer overflow",
+         "wasm trap: integer divide by zero",
+         "wasm trap: invalid conversion to integer",
+         "wasm trap: unreachable executed",
+         "wasm trap: call_indirect type mismatch",
+         "wasm trap: call stack exhausted"
+      };
+      eosio_assert(false, uint32_t(code) < sizeof(traps)/sizeof(traps[0]) ? traps[code] : "wasm trap");
+      __builtin_unreachable();
+   }
+
+   uint32_t wasm_rt_register_func_type(uint32_t params, uint32_t results, ...) {
+      static std::vector<std::vector<wasm_rt_type_t>> func_types;
+      std::vector<wasm_rt_type_t> sig;
+      sig.push_back(wasm_rt_type_t(params));
+      sig.push_back(wasm_rt_type_t(results));
+      va_list args;
+      va_start(args, results);
+      for (uint32_t i=0; i < params + results; i++)
+         sig.push_back(wasm_rt_type_t(va_arg(args, int)));
+      va_end(args);
+
+      for (uint32_t i=0; i < func_types.size(); i++)
+         if (func_types[i] == sig)
+            return i+1;
+      func_types.push_back(std::move(sig));
+      return func_types.size();
+   }
+
+   void wasm_rt_allocate_memory(wasm_rt_memory_t* mem, uint32_t initial_pages, uint32_t max_pages) {
+      free(mem->data);
+      mem->pages     = initial_pages;
+      mem->max_pages = max_pages;
+      mem->size      = initial_pages * 65536;
+      mem->data      = reinterpret_cast<uint8_t*>(calloc(mem->size ? mem->size : 1, 1));
+   }
+
+   uint32_t wasm_rt_grow_memory(wasm_rt_memory_t* mem, uint32_t delta) {
+      uint32_t old_pages = mem->pages;
+      uint64_t new_pages = uint64_t(old_pages) + delta;
+      if (new_pages > mem->max_pages || new_pages > 65536)
+         return uint32_t(-1);
+      uint8_t* data = reinterpret_cast<uint8_t*>(realloc(mem->data, new_pages * 65536));
+      if (!data)
+         return uint32_t(-1);
+      memset(data + mem->size, 0, delta * 65536);
+      mem->data  = data;
+      mem->pages = new_pages;
+      mem->size  = new_pages * 65536;
+      return old_pages;
+   }
+
+   void wasm_rt_allocate_table(wasm_rt_table_t* table, uint32_t elements, uint32_t max_elements) {
+      free(table->data);
+      table->size     = elements;
+      table->max_size = max_elements;
+      table->data     = reinterpret_cast<wasm_rt_elem_t*>(calloc(elements ? elements : 1, sizeof(wasm_rt_elem_t)));
+   }
+}
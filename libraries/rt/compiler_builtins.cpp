@@ -37,83 +37,148 @@ void __lshrti3(__int128& ret, uint64_t low, uint64_t high, uint32_t shift) {
    ret = (unsigned __int128)i;
 }
 
-void __divti3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
+// The 128-bit routines below only use 64-bit operations, 128-bit multiplication, division or variable
+// shifts would be lowered to calls of these same routines. Operands which fit in 64 bits, the common
+// case of amounts and prices, take a single 64-bit operation.
 
-   lhs /= rhs;
+// full 128-bit product of two 64-bit values from their 32-bit halves
+static inline void umul64(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+   uint64_t a_lo = a & 0xFFFFFFFFull, a_hi = a >> 32;
+   uint64_t b_lo = b & 0xFFFFFFFFull, b_hi = b >> 32;
+   uint64_t p0 = a_lo * b_lo;
+   uint64_t p1 = a_lo * b_hi;
+   uint64_t p2 = a_hi * b_lo;
+   uint64_t p3 = a_hi * b_hi;
+   uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFull) + (p2 & 0xFFFFFFFFull);
+   lo = (mid << 32) | (p0 & 0xFFFFFFFFull);
+   hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+}
 
-   ret = lhs;
+static inline uint32_t clz128(uint64_t lo, uint64_t hi) {
+   return hi ? __builtin_clzll(hi) : 64 + __builtin_clzll(lo);
 }
 
-void __udivti3(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   unsigned __int128 lhs = ha;
-   unsigned __int128 rhs = hb;
+// unsigned 128-bit quotient and remainder
+static void udivmod128(uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb,
+                       uint64_t& ql, uint64_t& qh, uint64_t& rl, uint64_t& rh) {
+   if ( (lb | hb) == 0 )
+      eosio_assert(false, "divide by zero");
+   if ( (ha | hb) == 0 ) {
+      ql = la / lb;
+      rl = la % lb;
+      qh = rh = 0;
+      return;
+   }
+   ql = qh = 0;
+   if ( hb > ha || (hb == ha && lb > la) ) {
+      rl = la;
+      rh = ha;
+      return;
+   }
+   // shift and subtract, one quotient bit per significant bit of the dividend beyond the divisor
+   uint32_t shift = clz128(lb, hb) - clz128(la, ha);
+   if ( shift >= 64 ) {
+      hb = lb << (shift - 64);
+      lb = 0;
+   } else if ( shift > 0 ) {
+      hb = (hb << shift) | (lb >> (64 - shift));
+      lb <<= shift;
+   }
+   for ( uint32_t i = 0; i <= shift; ++i ) {
+      qh = (qh << 1) | (ql >> 63);
+      ql <<= 1;
+      if ( ha > hb || (ha == hb && la >= lb) ) {
+         uint64_t borrow = la < lb;
+         la -= lb;
+         ha -= hb + borrow;
+         ql |= 1;
+      }
+      lb = (lb >> 1) | (hb << 63);
+      hb >>= 1;
+   }
+   rl = la;
+   rh = ha;
+}
 
-   lhs <<= 64;
-   lhs |=  la;
+static inline void negate128(uint64_t& lo, uint64_t& hi) {
+   lo = ~lo + 1;
+   hi = ~hi + (lo == 0);
+}
 
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
+static inline bool fits_int64(uint64_t lo, uint64_t hi) {
+   return hi == static_cast<uint64_t>(static_cast<int64_t>(lo) >> 63);
+}
 
-   lhs /= rhs;
-   ret = lhs;
+static inline void set128(__int128& ret, uint64_t lo, uint64_t hi) {
+   unsigned __int128 r = hi;
+   r <<= 64;
+   r |= lo;
+   ret = r;
 }
 
-void __multi3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
+// signed quotient or remainder, the remainder has the sign of the dividend
+static void divmod128(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb, bool remainder) {
+   if ( fits_int64(la, ha) && fits_int64(lb, hb) && lb != 0 &&
+        !(la == 0x8000000000000000ull && lb == ~0ull) ) {
+      int64_t a = static_cast<int64_t>(la);
+      int64_t b = static_cast<int64_t>(lb);
+      ret = remainder ? a % b : a / b;
+      return;
+   }
+   bool negative_a = static_cast<int64_t>(ha) < 0;
+   bool negative_b = static_cast<int64_t>(hb) < 0;
+   if ( negative_a )
+      negate128(la, ha);
+   if ( negative_b )
+      negate128(lb, hb);
+   uint64_t ql, qh, rl, rh;
+   udivmod128(la, ha, lb, hb, ql, qh, rl, rh);
+   if ( remainder ) {
+      if ( negative_a )
+         negate128(rl, rh);
+      set128(ret, rl, rh);
+   } else {
+      if ( negative_a != negative_b )
+         negate128(ql, qh);
+      set128(ret, ql, qh);
+   }
+}
 
-   lhs <<= 64;
-   lhs |=  la;
+void __divti3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+   divmod128(ret, la, ha, lb, hb, false);
+}
 
-   rhs <<= 64;
-   rhs |=  lb;
+void __udivti3(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+   uint64_t ql, qh, rl, rh;
+   udivmod128(la, ha, lb, hb, ql, qh, rl, rh);
+   ret = qh;
+   ret <<= 64;
+   ret |= ql;
+}
 
-   lhs *= rhs;
-   ret = lhs;
+void __multi3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
+   if ( (ha | hb | ((la | lb) >> 32)) == 0 ) {
+      // both operands are below 2^32
+      ret = la * lb;
+      return;
+   }
+   // the product modulo 2^128 is the same for signed and unsigned operands
+   uint64_t lo, hi;
+   umul64(la, lb, lo, hi);
+   hi += ha * lb + la * hb;
+   set128(ret, lo, hi);
 }
 
 void __modti3(__int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   __int128 lhs = ha;
-   __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
-
-   lhs %= rhs;
-   ret = lhs;
+   divmod128(ret, la, ha, lb, hb, true);
 }
 
 void __umodti3(unsigned __int128& ret, uint64_t la, uint64_t ha, uint64_t lb, uint64_t hb) {
-   unsigned __int128 lhs = ha;
-   unsigned __int128 rhs = hb;
-
-   lhs <<= 64;
-   lhs |=  la;
-
-   rhs <<= 64;
-   rhs |=  lb;
-   //if ( rhs == 0 )
-   //   eosio_assert(false, "divide by zero");
-
-   lhs %= rhs;
-   ret = lhs;
+   uint64_t ql, qh, rl, rh;
+   udivmod128(la, ha, lb, hb, ql, qh, rl, rh);
+   ret = rh;
+   ret <<= 64;
+   ret |= rl;
 }
 
 // arithmetic long double
@@ -69,6 +69,8 @@ eosio_clang_install(wasm-ld)
 eosio_tool_install_and_symlink(eosio-pp eosio-pp)
 eosio_tool_install_and_symlink(eosio-wast2wasm eosio-wast2wasm)
 eosio_tool_install_and_symlink(eosio-wasm2wast eosio-wasm2wast)
+eosio_tool_install_and_symlink(eosio-wasm2native eosio-wasm2native)
+eosio_tool_install_and_symlink(eosio-wasm-profile eosio-wasm-profile)
 eosio_tool_install_and_symlink(eosio-cc eosio-cc)
 eosio_tool_install_and_symlink(eosio-cpp eosio-cpp)
 eosio_tool_install_and_symlink(eosio-ld eosio-ld)
@@ -0,0 +1,19 @@
+/*
+ * Verifies that -error-codes keeps the messages of every file of a contract, including the files
+ * compiled after the one with the actions, in the ABI and in the error table written next to the wasm
+ */
+
+#include <eosio/eosio.hpp>
+
+void check_value(uint64_t value);
+
+class [[eosio::contract]] error_codes_multi_file : public eosio::contract {
+   public:
+      using eosio::contract::contract;
+
+      [[eosio::action]]
+      void act(uint64_t amount) {
+         eosio::check(amount > 0, "amount must be positive");
+         check_value(amount);
+      }
+};
@@ -0,0 +1,10 @@
+/*
+ * Helper file of error_codes_multi_file.cpp, it has no actions and is compiled after the contract file
+ */
+
+#include <eosio/eosio.hpp>
+
+void check_value(uint64_t value) {
+   eosio::check(value < 1000, "value is too large");
+   eosio::check(value % 2 == 0, "value must be even");
+}
@@ -0,0 +1,22 @@
+/*
+ * Verifies that -size-report attributes the member functions of a C++ contract to the contract, which needs
+ * the names of the symbols file and of the name section to be demangled alike
+ */
+
+#include <eosio/eosio.hpp>
+
+class [[eosio::contract]] size_report : public eosio::contract {
+   public:
+      using eosio::contract::contract;
+
+      [[eosio::action]]
+      void hi(eosio::name user) {
+         greet(user);
+      }
+
+   private:
+      [[gnu::noinline]]
+      void greet(eosio::name user) {
+         eosio::print("hello ", user);
+      }
+};
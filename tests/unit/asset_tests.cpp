@@ -276,6 +276,21 @@ EOSIO_TEST_BEGIN(asset_type_test)
       })
    )
 
+   // products which don't fit in 64 bits
+   CHECK_EQUAL( (asset{ asset_max, sym_no_prec} *= 1LL ), (asset{ asset_max, sym_no_prec}) );
+   CHECK_EQUAL( (asset{ 1LL << 31, sym_no_prec} *= (1LL << 30) ), (asset{ 1LL << 61, sym_no_prec}) );
+   CHECK_EQUAL( (asset{ -(1LL << 31), sym_no_prec} *= (1LL << 30) ), (asset{ -(1LL << 61), sym_no_prec}) );
+   CHECK_ASSERT( "multiplication overflow", (
+      [&]() {
+         asset{ -(1LL << 40), sym_no_prec} *= -(1LL << 40);
+      })
+   )
+   CHECK_ASSERT( "multiplication underflow", (
+      [&]() {
+         asset{ asset_max, sym_no_prec} *= std::numeric_limits<int64_t>::min();
+      })
+   )
+
    // ---------------------------------------------
    // friend asset operator/(const asset&, int64_t)
    CHECK_EQUAL( (asset{ 0LL, sym_no_prec} / asset{ 1LL, sym_no_prec}.amount), (asset{ 0LL, sym_no_prec}) )
@@ -354,6 +369,41 @@ EOSIO_TEST_BEGIN(asset_type_test)
    // friend bool operator>=( const asset&, const asset&)
    CHECK_EQUAL( ( asset{1LL, sym_no_prec} >= asset{0LL, sym_no_prec} ), true )
    CHECK_EQUAL( ( asset{1LL, sym_no_prec} >= asset{1LL, sym_no_prec} ), true )
+
+   // -------------------------------------------
+   // static asset from_string(std::string_view)
+   CHECK_EQUAL( asset::from_string("0 SYMBOLL"), (asset{0LL, sym_no_prec}) )
+   CHECK_EQUAL( asset::from_string("-1 SYMBOLL"), (asset{-1LL, sym_no_prec}) )
+   CHECK_EQUAL( asset::from_string("1.0000 EOS"), (asset{10000LL, symbol{"EOS", 4}}) )
+   CHECK_EQUAL( asset::from_string("-0.12 SYMBOLL"), (asset{-12LL, symbol{"SYMBOLL", 2}}) )
+   CHECK_EQUAL( asset::from_string("  12.3   A  "), (asset{123LL, symbol{"A", 1}}) )
+   CHECK_EQUAL( asset::from_string("4611686018427387903 SYMBOLL"), (asset{asset_max, sym_no_prec}) )
+   CHECK_EQUAL( asset::from_string("-46116860184273879.03 SYMBOLL"), (asset{asset_min, symbol{"SYMBOLL", 2}}) )
+   CHECK_EQUAL( asset::from_string("0.000000000000000000000000000000000000000000004611686018427387903 SYMBOLL"),
+                (asset{asset_max, sym_prec}) )
+   CHECK_EQUAL( asset::from_string("1.0000 EOS").symbol.precision(), 4 )
+
+   // formatting and parsing round trip
+   const int64_t amounts[] = {0LL, 1LL, -1LL, 9LL, 10LL, 99LL, 100LL, 12345LL, -98765432LL, asset_min, asset_max};
+   const uint8_t precisions[] = {0, 1, 2, 4, 8, 18, 19, 20, 63};
+   for( int64_t amount : amounts ) {
+      for( uint8_t precision : precisions ) {
+         const asset a{amount, symbol{"SYMBOLL", precision}};
+         CHECK_EQUAL( asset::from_string(a.to_string()), a )
+      }
+   }
+
+   CHECK_ASSERT( "asset string is empty", []() { asset::from_string("  "); } )
+   CHECK_ASSERT( "asset amount and symbol should be separated with a space", []() { asset::from_string("1.0000EOS"); } )
+   CHECK_ASSERT( "asset amount must be a decimal number", []() { asset::from_string("1,0000 EOS"); } )
+   CHECK_ASSERT( "asset amount must be a decimal number", []() { asset::from_string("1.0.0 EOS"); } )
+   CHECK_ASSERT( "asset amount must be a decimal number", []() { asset::from_string("- EOS"); } )
+   CHECK_ASSERT( "asset amount needs digits before and after the decimal point", []() { asset::from_string("1. EOS"); } )
+   CHECK_ASSERT( "asset amount needs digits before and after the decimal point", []() { asset::from_string(".1 EOS"); } )
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", []() { asset::from_string("4611686018427387904 EOS"); } )
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", []() { asset::from_string("100000000000000000000 EOS"); } )
+   CHECK_ASSERT( "only uppercase letters allowed in symbol_code string", []() { asset::from_string("1.0000 eos"); } )
+   CHECK_ASSERT( "string is too long to be a valid symbol_code", []() { asset::from_string("1.0000 EOSEOSEOS"); } )
 EOSIO_TEST_END
 
 // Definitions in `eosio.cdt/libraries/eosio/asset.hpp`
@@ -533,6 +583,78 @@ EOSIO_TEST_BEGIN(extended_asset_type_test)
    )
 EOSIO_TEST_END
 
+EOSIO_TEST_BEGIN(asset_math_test)
+   using eosio::asset_math::muldiv;
+   using eosio::asset_math::convert;
+   constexpr int64_t int64_max = std::numeric_limits<int64_t>::max();
+   constexpr int64_t int64_min = std::numeric_limits<int64_t>::min();
+
+   // ---------------------------------------------------
+   // int64_t muldiv(int64_t, int64_t, int64_t, bool)
+   CHECK_EQUAL( muldiv(0, 5, 7), 0 )
+   CHECK_EQUAL( muldiv(10, 3, 4), 7 )
+   CHECK_EQUAL( muldiv(10, 3, 4, true), 8 )
+   CHECK_EQUAL( muldiv(-10, 3, 4), -7 )
+   CHECK_EQUAL( muldiv(-10, 3, 4, true), -7 )
+   CHECK_EQUAL( muldiv(10, -3, -4), 7 )
+   CHECK_EQUAL( muldiv(12, 3, 4, true), 9 )
+   // the product doesn't fit in 64 bits
+   CHECK_EQUAL( muldiv(int64_max, int64_max, int64_max), int64_max )
+   CHECK_EQUAL( muldiv(int64_min, int64_max, int64_max), int64_min )
+   CHECK_EQUAL( muldiv(int64_min, int64_min, int64_min), int64_min )
+   CHECK_EQUAL( muldiv(asset_max, 1000000007LL, 1000000009LL), 4611686009204015949LL )
+   CHECK_EQUAL( muldiv(asset_max, 1000000007LL, 1000000009LL, true), 4611686009204015950LL )
+
+   CHECK_ASSERT( "divide by zero", []() { muldiv(1, 1, 0); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv(int64_max, 2, 1); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv(int64_min, -1, 1); } )
+   CHECK_ASSERT( "muldiv overflow", []() { muldiv(int64_max, int64_max, 1); } )
+
+   // ------------------------------------------------------
+   // asset muldiv(const asset&, int64_t, int64_t, bool)
+   const asset quantity{12345678LL, symbol{"EOS", 4}};
+   CHECK_EQUAL( muldiv(quantity, 25, 10000), (asset{30864LL, symbol{"EOS", 4}}) )
+   CHECK_EQUAL( muldiv(quantity, 25, 10000, true), (asset{30865LL, symbol{"EOS", 4}}) )
+   CHECK_ASSERT( "magnitude of asset amount must be less than 2^62", []() { muldiv(asset{asset_max, symbol{"EOS", 4}}, 2, 1); } )
+
+   // ----------------------------------------------------
+   // asset convert(const asset&, const asset&, bool)
+   CHECK_EQUAL( convert(asset{20000LL, symbol{"EOS", 4}}, asset{50LL, symbol{"USD", 2}}), (asset{100LL, symbol{"USD", 2}}) )
+   CHECK_EQUAL( convert(asset{12345LL, symbol{"EOS", 4}}, asset{333LL, symbol{"USD", 2}}), (asset{411LL, symbol{"USD", 2}}) )
+   CHECK_EQUAL( convert(asset{12345LL, symbol{"EOS", 4}}, asset{333LL, symbol{"USD", 2}}, true), (asset{412LL, symbol{"USD", 2}}) )
+   CHECK_ASSERT( "precision of asset is too large", []() { convert(asset{1LL, symbol{"EOS", 19}}, asset{1LL, symbol{"USD", 2}}); } )
+EOSIO_TEST_END
+
+// Formatting and parsing of assets as in memos, run with -v to see the results
+EOSIO_TEST_BEGIN(asset_bench)
+   const asset a{-123456789LL, symbol{"EOS", 4}};
+   EOSIO_BENCH( "asset::write_as_string", 100000,
+      char buffer[32];
+      auto end = asset{a.amount + int64_t(__bench_i), a.symbol}.write_as_string( buffer, buffer + sizeof(buffer) );
+      bench_do_not_optimize(end);
+   )
+   EOSIO_BENCH( "asset::to_string", 100000,
+      auto str = asset{a.amount + int64_t(__bench_i), a.symbol}.to_string();
+      bench_do_not_optimize(str);
+   )
+   static const char* const strs[] = {"-12345.6789 EOS", "1.0000 EOS", "0.0001 EOS", "4611686018427.3879 EOS"};
+   EOSIO_BENCH( "asset::from_string", 100000,
+      auto parsed = asset::from_string(strs[__bench_i % 4]);
+      bench_do_not_optimize(parsed);
+   )
+   CHECK_EQUAL( a.to_string(), "-12345.6789 EOS" )
+   CHECK_EQUAL( asset::from_string(a.to_string()), a )
+
+   EOSIO_BENCH( "asset_math::muldiv 64-bit product", 100000,
+      auto r = eosio::asset_math::muldiv(int64_t(__bench_i), 997, 1000);
+      bench_do_not_optimize(r);
+   )
+   EOSIO_BENCH( "asset_math::muldiv 128-bit product", 100000,
+      auto r = eosio::asset_math::muldiv(asset_max - int64_t(__bench_i), 997, 1000);
+      bench_do_not_optimize(r);
+   )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -542,5 +664,7 @@ int main(int argc, char* argv[]) {
 
    EOSIO_TEST(asset_type_test);
    EOSIO_TEST(extended_asset_type_test);
+   EOSIO_TEST(asset_math_test);
+   EOSIO_TEST(asset_bench);
    return has_failed();
 }
@@ -6,7 +6,16 @@
 #include <eosio/tester.hpp>
 #include <eosio/crypto.hpp>
 
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace eosio::native;
+using std::array;
+using std::vector;
+
 using eosio::public_key;
+using eosio::sha256_packed;
 using eosio::signature;
 
 // Definitions in `eosio.cdt/libraries/eosio/crypto.hpp`
@@ -35,6 +44,75 @@ EOSIO_TEST_BEGIN(signature_type_test)
    CHECK_EQUAL( (signature(std::in_place_index<0>, std::array<char, 65>{})  != signature(std::in_place_index<0>, std::array<char, 65>{})), false )
 EOSIO_TEST_END
 
+// SHA256 for the `sha256` intrinsic, which the native tester doesn't provide
+static array<uint8_t, 32> reference_sha256( const char* data, size_t size ) {
+   static constexpr uint32_t k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+   };
+   uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+   const auto rotr = []( uint32_t x, uint32_t n ) { return (x >> n) | (x << (32 - n)); };
+
+   vector<uint8_t> msg( data, data + size );
+   msg.push_back( 0x80 );
+   while ( msg.size() % 64 != 56 )
+      msg.push_back( 0 );
+   for ( int i = 7; i >= 0; i-- )
+      msg.push_back( uint8_t((static_cast<uint64_t>(size) * 8) >> (i * 8)) );
+
+   for ( size_t block = 0; block < msg.size(); block += 64 ) {
+      uint32_t w[64];
+      for ( int i = 0; i < 16; i++ )
+         w[i] = uint32_t(msg[block+i*4]) << 24 | uint32_t(msg[block+i*4+1]) << 16 | uint32_t(msg[block+i*4+2]) << 8 | msg[block+i*4+3];
+      for ( int i = 16; i < 64; i++ )
+         w[i] = w[i-16] + (rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3)) + w[i-7] + (rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10));
+      uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+      for ( int i = 0; i < 64; i++ ) {
+         uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+         uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+         h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+      }
+      state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+   }
+
+   array<uint8_t, 32> digest;
+   for ( int i = 0; i < 32; i++ )
+      digest[i] = uint8_t(state[i / 4] >> (24 - 8 * (i % 4)));
+   return digest;
+}
+
+// Definitions in `eosio.cdt/libraries/eosio/crypto.hpp`
+EOSIO_TEST_BEGIN(sha256_packed_test)
+   size_t sha256_calls = 0;
+   intrinsics::set_intrinsic<intrinsics::sha256>([&]( const char* data, uint32_t length, capi_checksum256* hash ) {
+      ++sha256_calls;
+      const auto digest = reference_sha256( data, length );
+      memcpy( hash->hash, digest.data(), digest.size() );
+   });
+
+   // values which are packed on the stack
+   CHECK_EQUAL( sha256_packed(std::string("abc")).extract_as_byte_array(), reference_sha256( "\x03" "abc", 4 ) )
+
+   // larger values are packed into an allocation and still hashed by one call to the intrinsic
+   static constexpr array<uint8_t, 32> packed_digest{ 0xb0, 0xfa, 0x73, 0x0a, 0x99, 0x5f, 0x1d, 0x41, 0x6f, 0xea, 0x3d, 0x38, 0x2d, 0xe1, 0xe9, 0xc8,
+                                                      0xdf, 0xb6, 0x08, 0x42, 0x2e, 0x30, 0x60, 0x3a, 0x95, 0x3f, 0x66, 0xf7, 0x65, 0xe8, 0x17, 0xc5 };
+   sha256_calls = 0;
+   CHECK_EQUAL( sha256_packed(vector<char>(1000, 'a')).extract_as_byte_array(), packed_digest )
+   CHECK_EQUAL( sha256_calls, 1 )
+
+   // values packed to the size of the stack buffer and one byte more
+   const vector<char> edge(510, 'a');
+   CHECK_EQUAL( sha256_packed(edge).extract_as_byte_array(), reference_sha256( eosio::pack(edge).data(), 512 ) )
+   const vector<char> over(511, 'a');
+   CHECK_EQUAL( sha256_packed(over).extract_as_byte_array(), reference_sha256( eosio::pack(over).data(), 513 ) )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -44,5 +122,6 @@ int main(int argc, char* argv[]) {
 
    EOSIO_TEST(public_key_type_test)
    EOSIO_TEST(signature_type_test)
+   EOSIO_TEST(sha256_packed_test)
    return has_failed();
 }
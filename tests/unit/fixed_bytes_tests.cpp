@@ -102,43 +102,65 @@ EOSIO_TEST_BEGIN(fixed_bytes_test)
 
    CHECK_EQUAL( (fixed_bytes<32>{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}}.extract_as_byte_array()), extract_arr )
 
-   // ----------------------------
-   // const auto& get_array()const
+   // ----------------------------------------------
+   // array<word_t, num_words()> get_array()const
    CHECK_EQUAL( (fixed_bytes<0>{}.get_array()), (array<uint128_t, 0>{}) )
    CHECK_EQUAL( (fixed_bytes<1>{}.get_array()), (array<uint128_t, 1>{}) )
    CHECK_EQUAL( (fixed_bytes<32>{}.get_array()), (array<uint128_t, 2>{}) )
    CHECK_EQUAL( (fixed_bytes<512>{}.get_array()), (array<uint128_t, 32>{}) )
-
-   // -----------
-   // auto data()
+   CHECK_EQUAL( (fixed_bytes<32>{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}}.get_array()),
+                (array<uint128_t, 2>{(uint128_t(1) << 64) | 2, (uint128_t(3) << 64) | 4}) )
+   CHECK_EQUAL( (fixed_bytes<20>{array<uint8_t, 20>{1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20}}.get_array()[1]),
+                (uint128_t(0x11121314) << 96) )
+
+   // the word format round trips
+   static const array<uint128_t, 2> words{ (uint128_t(0x0102030405060708ULL) << 64) | 0x090a0b0c0d0e0f10ULL, 42 };
+   CHECK_EQUAL( (fixed_bytes<32>{words}.get_array()), words )
+   CHECK_EQUAL( (fixed_bytes<32>{words}.bytes()[0]), 1 )
+   CHECK_EQUAL( (fixed_bytes<32>{words}.bytes()[15]), 16 )
+   CHECK_EQUAL( (fixed_bytes<32>{words}.bytes()[31]), 42 )
+
+   // ------------------
+   // uint8_t* bytes()
+   fixed_bytes<32> fb_data{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}};
+   fb_data.bytes()[0] = 0xff;
+   CHECK_EQUAL( fb_data.extract_as_byte_array()[0], 0xff )
+   CHECK_EQUAL( fb_data.extract_as_byte_array()[7], 1 )
+
+   // ---------------------------
+   // const uint8_t* bytes()const
+   static const fixed_bytes<32> cfb_data{array<uint64_t, 4>{1ULL,2ULL,3ULL,4ULL}};
+   CHECK_EQUAL( memcmp(cfb_data.bytes(), extract_arr.data(), extract_arr.size()), 0 )
+
+   // -------------------------------
+   // static constexpr size_t byte_size()
+   CHECK_EQUAL( fixed_bytes<0>::byte_size(), 0 )
+   CHECK_EQUAL( fixed_bytes<1>::byte_size(), 1 )
+   CHECK_EQUAL( fixed_bytes<20>::byte_size(), 20 )
+   CHECK_EQUAL( fixed_bytes<32>::byte_size(), 32 )
+   CHECK_EQUAL( fixed_bytes<512>::byte_size(), 512 )
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+   // -------------------------------------------
+   // deprecated: auto data(), auto size()const
+   // the storage is still size() words, so copying it never reads past the object
    static constexpr fixed_bytes<0> fb_data0{};
    static constexpr fixed_bytes<1> fb_data1{};
    static constexpr fixed_bytes<32> fb_data2{};
    static constexpr fixed_bytes<512> fb_data3{};
 
-   CHECK_EQUAL( fb_data0.data(), fb_data0.get_array().data() )
-   CHECK_EQUAL( fb_data1.data(), fb_data1.get_array().data() )
-   CHECK_EQUAL( fb_data2.data(), fb_data2.get_array().data() )
-   CHECK_EQUAL( fb_data3.data(), fb_data3.get_array().data() )
-
-   // ----------------
-   // auto data()const
-   static constexpr fixed_bytes<0> cfb_data0{};
-   static constexpr fixed_bytes<1> cfb_data1{};
-   static constexpr fixed_bytes<32> cfb_data2{};
-   static constexpr fixed_bytes<512> cfb_data3{};
-
-   CHECK_EQUAL( cfb_data0.data(), cfb_data0.get_array().data() )
-   CHECK_EQUAL( cfb_data1.data(), cfb_data1.get_array().data() )
-   CHECK_EQUAL( cfb_data2.data(), cfb_data2.get_array().data() )
-   CHECK_EQUAL( cfb_data3.data(), cfb_data3.get_array().data() )
-
-   // ----------------
-   // auto size()const
+   CHECK_EQUAL( (const void*)fb_data0.data(), (const void*)fb_data0.bytes() )
+   CHECK_EQUAL( (const void*)fb_data1.data(), (const void*)fb_data1.bytes() )
+   CHECK_EQUAL( (const void*)fb_data2.data(), (const void*)fb_data2.bytes() )
+   CHECK_EQUAL( (const void*)fb_data3.data(), (const void*)fb_data3.bytes() )
+
    CHECK_EQUAL( fixed_bytes<0>{}.size(), 0 )
    CHECK_EQUAL( fixed_bytes<1>{}.size(), 1 )
    CHECK_EQUAL( fixed_bytes<32>{}.size(), 2 )
    CHECK_EQUAL( fixed_bytes<512>{}.size(), 32 )
+   CHECK_EQUAL( fixed_bytes<32>{}.size() * sizeof(uint128_t), sizeof(fixed_bytes<32>) )
+#pragma GCC diagnostic pop
 
    // ---------------------------------------------------------------------------
    // friend bool operator== <>(const fixed_bytes<Size>, const fixed_bytes<Size>)
@@ -173,6 +195,49 @@ EOSIO_TEST_BEGIN(fixed_bytes_test)
    // friend bool operator>= <>(const fixed_bytes<Size>, const fixed_bytes<Size>)
    CHECK_EQUAL( fb_cmp1 >= fb_cmp1, true  )
    CHECK_EQUAL( fb_cmp1 >= fb_cmp2, false )
+
+   // the order is the order of the bytes, not of the 64-bit words in memory
+   static const fixed_bytes<32> fb_lo{array<uint8_t, 8>{0x01,0,0,0,0,0,0,0xff}};
+   static const fixed_bytes<32> fb_hi{array<uint8_t, 8>{0x02,0,0,0,0,0,0,0x00}};
+   CHECK_EQUAL( fb_lo <  fb_hi, true  )
+   CHECK_EQUAL( fb_hi >  fb_lo, true  )
+   CHECK_EQUAL( fb_lo == fb_hi, false )
+   CHECK_EQUAL( (fixed_bytes<20>{array<uint8_t, 20>{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1}} >
+                 fixed_bytes<20>{array<uint8_t, 19>{}}), true )
+EOSIO_TEST_END
+
+// Benchmarks of the operations multi_index performs on checksum256 secondary keys, run with -v to see them
+EOSIO_TEST_BEGIN(fixed_bytes_bench)
+   array<uint8_t, 32> bytes{};
+   for ( size_t i = 0; i < bytes.size(); i++ )
+      bytes[i] = i;
+   const fixed_bytes<32> a{bytes};
+   bytes[31] = 0;
+   const fixed_bytes<32> b{bytes};
+
+   EOSIO_BENCH( "fixed_bytes<32> from bytes", 100000,
+      bytes[0] = __bench_i;
+      fixed_bytes<32> fb{bytes};
+      bench_do_not_optimize(fb);
+   )
+   EOSIO_BENCH( "fixed_bytes<32> from uint64_t words", 100000,
+      auto fb = fixed_bytes<32>::make_from_word_sequence<uint64_t>(__bench_i, 2ULL, 3ULL, 4ULL);
+      bench_do_not_optimize(fb);
+   )
+   EOSIO_BENCH( "fixed_bytes<32> ==", 100000,
+      bool r = a == b;
+      bench_do_not_optimize(r);
+   )
+   EOSIO_BENCH( "fixed_bytes<32> <", 100000,
+      bool r = b < a;
+      bench_do_not_optimize(r);
+   )
+   EOSIO_BENCH( "fixed_bytes<32> db_idx256 round trip", 100000,
+      auto fb = fixed_bytes<32>{a.get_array()};
+      bench_do_not_optimize(fb);
+   )
+   CHECK_EQUAL( (fixed_bytes<32>{a.get_array()}), a )
+   CHECK_EQUAL( b < a, true )
 EOSIO_TEST_END
 
 int main(int argc, char* argv[]) {
@@ -183,5 +248,6 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(fixed_bytes_test);
+   EOSIO_TEST(fixed_bytes_bench);
    return has_failed();
 }
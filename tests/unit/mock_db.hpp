@@ -0,0 +1,300 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+#pragma once
+
+#include <eosio/tester.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * In memory database behind the db intrinsics of the native tester, so that tables can be tested
+ * and the host calls they make counted. Iterators are indices of rows, the end iterator of a table
+ * is -2 minus the index of the table. Only the idx64 secondary indices are supported.
+ */
+namespace mock_db {
+   using eosio::native::intrinsics;
+
+   struct row {
+      uint64_t          code;
+      uint64_t          scope;
+      uint64_t          table;
+      uint64_t          primary_key;
+      uint64_t          payer;
+      std::vector<char> data;
+      bool              removed = false;
+   };
+
+   struct table_id {
+      uint64_t code;
+      uint64_t scope;
+      uint64_t table;
+      bool operator==( const table_id& t )const { return code == t.code && scope == t.scope && table == t.table; }
+   };
+
+   struct idx64_entry {
+      uint64_t code;
+      uint64_t scope;
+      uint64_t table;
+      uint64_t primary_key;
+      uint64_t payer;
+      uint64_t secondary;
+      bool     removed = false;
+   };
+
+   inline std::vector<row>         rows;
+   inline std::vector<idx64_entry> idx64_entries;
+   inline std::vector<table_id>    tables;
+   inline uint64_t              receiver = 0;
+
+   /// number of calls of each db intrinsic since the last reset
+   inline std::map<std::string, size_t> calls;
+
+   inline size_t host_calls() {
+      size_t n = 0;
+      for( const auto& c : calls )
+         n += c.second;
+      return n;
+   }
+
+   inline int32_t end_iterator( const table_id& t ) {
+      for( size_t i = 0; i < tables.size(); i++ )
+         if( tables[i] == t )
+            return -2 - int32_t(i);
+      tables.push_back( t );
+      return -2 - int32_t(tables.size() - 1);
+   }
+
+   inline table_id table_of( int32_t itr ) {
+      if( itr < -1 )
+         return tables.at( size_t(-2 - itr) );
+      const row& r = rows.at( size_t(itr) );
+      return {r.code, r.scope, r.table};
+   }
+
+   inline row& row_of( int32_t itr ) {
+      eosio::check( itr >= 0 && size_t(itr) < rows.size() && !rows[itr].removed, "mock_db: invalid iterator" );
+      return rows[itr];
+   }
+
+   // the live row of `t` with the smallest primary key accepted by `pred`, searching from the largest if `last`
+   template <typename Pred>
+   int32_t find_row( const table_id& t, Pred&& pred, bool last=false ) {
+      int32_t found = -1;
+      for( size_t i = 0; i < rows.size(); i++ ) {
+         const row& r = rows[i];
+         if( r.removed || !(table_id{r.code, r.scope, r.table} == t) || !pred(r.primary_key) )
+            continue;
+         if( found < 0 || (last ? r.primary_key > rows[found].primary_key : r.primary_key < rows[found].primary_key) )
+            found = int32_t(i);
+      }
+      return found;
+   }
+
+   inline int32_t find_or_end( const table_id& t, int32_t itr ) {
+      return itr >= 0 ? itr : end_iterator( t );
+   }
+
+   inline table_id idx64_table_of( int32_t itr ) {
+      if( itr < -1 )
+         return tables.at( size_t(-2 - itr) );
+      const idx64_entry& e = idx64_entries.at( size_t(itr) );
+      return {e.code, e.scope, e.table};
+   }
+
+   inline idx64_entry& idx64_entry_of( int32_t itr ) {
+      eosio::check( itr >= 0 && size_t(itr) < idx64_entries.size() && !idx64_entries[itr].removed, "mock_db: invalid idx64 iterator" );
+      return idx64_entries[itr];
+   }
+
+   // the live entry of `t` with the smallest (secondary, primary key) accepted by `pred`, the largest if `last`
+   template <typename Pred>
+   int32_t find_idx64_entry( const table_id& t, Pred&& pred, bool last=false ) {
+      int32_t found = -1;
+      for( size_t i = 0; i < idx64_entries.size(); i++ ) {
+         const idx64_entry& e = idx64_entries[i];
+         if( e.removed || !(table_id{e.code, e.scope, e.table} == t) || !pred(e.secondary, e.primary_key) )
+            continue;
+         if( found < 0 )
+            found = int32_t(i);
+         const idx64_entry& f = idx64_entries[found];
+         if( last ? std::tie(e.secondary, e.primary_key) > std::tie(f.secondary, f.primary_key)
+                  : std::tie(e.secondary, e.primary_key) < std::tie(f.secondary, f.primary_key) )
+            found = int32_t(i);
+      }
+      return found;
+   }
+
+   inline int32_t idx64_result( const table_id& t, int32_t itr, uint64_t* secondary, uint64_t* primary ) {
+      if( itr < 0 )
+         return end_iterator( t );
+      if( secondary )
+         *secondary = idx64_entries[itr].secondary;
+      *primary = idx64_entries[itr].primary_key;
+      return itr;
+   }
+
+   /// empties the database and makes `code` the receiver of the action
+   inline void reset( eosio::name code ) {
+      rows.clear();
+      idx64_entries.clear();
+      tables.clear();
+      calls.clear();
+      receiver = code.value;
+   }
+
+   inline void install() {
+      intrinsics::set_intrinsic<intrinsics::current_receiver>([]() { return receiver; });
+      intrinsics::set_intrinsic<intrinsics::db_store_i64>(
+         [](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+            ++calls["db_store_i64"];
+            table_id t{receiver, scope, table};
+            eosio::check( find_row( t, [&](uint64_t pk) { return pk == id; } ) < 0, "mock_db: duplicate primary key" );
+            end_iterator( t );
+            rows.push_back( row{receiver, scope, table, id, payer, {(const char*)data, (const char*)data + len}} );
+            return int32_t(rows.size() - 1);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_update_i64>(
+         [](int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+            ++calls["db_update_i64"];
+            row& r = row_of( itr );
+            if( payer )
+               r.payer = payer;
+            r.data.assign( (const char*)data, (const char*)data + len );
+         });
+      intrinsics::set_intrinsic<intrinsics::db_remove_i64>([](int32_t itr) {
+         ++calls["db_remove_i64"];
+         row_of( itr ).removed = true;
+      });
+      intrinsics::set_intrinsic<intrinsics::db_get_i64>([](int32_t itr, const void* data, uint32_t len) {
+         ++calls["db_get_i64"];
+         // like the chain, returns the size of the row for an empty buffer and otherwise how much was copied
+         const row& r = row_of( itr );
+         if( len == 0 )
+            return int32_t(r.data.size());
+         const size_t copied = std::min<size_t>( len, r.data.size() );
+         memcpy( (void*)data, r.data.data(), copied );
+         return int32_t(copied);
+      });
+      intrinsics::set_intrinsic<intrinsics::db_next_i64>([](int32_t itr, uint64_t* primary) {
+         ++calls["db_next_i64"];
+         const uint64_t pk = row_of( itr ).primary_key;
+         const table_id t  = table_of( itr );
+         int32_t next = find_row( t, [&](uint64_t k) { return k > pk; } );
+         if( next >= 0 )
+            *primary = rows[next].primary_key;
+         return find_or_end( t, next );
+      });
+      intrinsics::set_intrinsic<intrinsics::db_previous_i64>([](int32_t itr, uint64_t* primary) {
+         ++calls["db_previous_i64"];
+         const table_id t = table_of( itr );
+         int32_t prev = itr < -1 ? find_row( t, [](uint64_t) { return true; }, true )
+                                 : find_row( t, [&, pk = row_of( itr ).primary_key](uint64_t k) { return k < pk; }, true );
+         if( prev >= 0 )
+            *primary = rows[prev].primary_key;
+         return prev;
+      });
+      intrinsics::set_intrinsic<intrinsics::db_find_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+         ++calls["db_find_i64"];
+         table_id t{code, scope, table};
+         return find_or_end( t, find_row( t, [&](uint64_t pk) { return pk == id; } ) );
+      });
+      intrinsics::set_intrinsic<intrinsics::db_lowerbound_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+         ++calls["db_lowerbound_i64"];
+         table_id t{code, scope, table};
+         return find_or_end( t, find_row( t, [&](uint64_t pk) { return pk >= id; } ) );
+      });
+      intrinsics::set_intrinsic<intrinsics::db_upperbound_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+         ++calls["db_upperbound_i64"];
+         table_id t{code, scope, table};
+         return find_or_end( t, find_row( t, [&](uint64_t pk) { return pk > id; } ) );
+      });
+      intrinsics::set_intrinsic<intrinsics::db_end_i64>([](uint64_t code, uint64_t scope, uint64_t table) {
+         ++calls["db_end_i64"];
+         return end_iterator( table_id{code, scope, table} );
+      });
+
+      intrinsics::set_intrinsic<intrinsics::db_idx64_store>(
+         [](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary) {
+            ++calls["db_idx64_store"];
+            end_iterator( table_id{receiver, scope, table} );
+            idx64_entries.push_back( idx64_entry{receiver, scope, table, id, payer, *secondary} );
+            return int32_t(idx64_entries.size() - 1);
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_update>([](int32_t itr, uint64_t payer, const uint64_t* secondary) {
+         ++calls["db_idx64_update"];
+         idx64_entry& e = idx64_entry_of( itr );
+         if( payer )
+            e.payer = payer;
+         e.secondary = *secondary;
+      });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_remove>([](int32_t itr) {
+         ++calls["db_idx64_remove"];
+         idx64_entry_of( itr ).removed = true;
+      });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_next>([](int32_t itr, uint64_t* primary) {
+         ++calls["db_idx64_next"];
+         const idx64_entry e = idx64_entry_of( itr );
+         const table_id t    = idx64_table_of( itr );
+         return idx64_result( t, find_idx64_entry( t, [&](uint64_t s, uint64_t pk) {
+            return std::tie(s, pk) > std::tie(e.secondary, e.primary_key);
+         } ), nullptr, primary );
+      });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_previous>([](int32_t itr, uint64_t* primary) {
+         ++calls["db_idx64_previous"];
+         const table_id t = idx64_table_of( itr );
+         int32_t prev = -1;
+         if( itr < -1 ) {
+            prev = find_idx64_entry( t, [](uint64_t, uint64_t) { return true; }, true );
+         } else {
+            const idx64_entry e = idx64_entry_of( itr );
+            prev = find_idx64_entry( t, [&](uint64_t s, uint64_t pk) {
+               return std::tie(s, pk) < std::tie(e.secondary, e.primary_key);
+            }, true );
+         }
+         if( prev >= 0 )
+            *primary = idx64_entries[prev].primary_key;
+         return prev;
+      });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_find_primary>(
+         [](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t primary) {
+            ++calls["db_idx64_find_primary"];
+            table_id t{code, scope, table};
+            int32_t itr = find_idx64_entry( t, [&](uint64_t, uint64_t pk) { return pk == primary; } );
+            if( itr < 0 )
+               return end_iterator( t );
+            *secondary = idx64_entries[itr].secondary;
+            return itr;
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_find_secondary>(
+         [](uint64_t code, uint64_t scope, uint64_t table, const uint64_t* secondary, uint64_t* primary) {
+            ++calls["db_idx64_find_secondary"];
+            table_id t{code, scope, table};
+            return idx64_result( t, find_idx64_entry( t, [&](uint64_t s, uint64_t) { return s == *secondary; } ), nullptr, primary );
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_lowerbound>(
+         [](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+            ++calls["db_idx64_lowerbound"];
+            table_id t{code, scope, table};
+            const uint64_t key = *secondary;
+            return idx64_result( t, find_idx64_entry( t, [&](uint64_t s, uint64_t) { return s >= key; } ), secondary, primary );
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_upperbound>(
+         [](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+            ++calls["db_idx64_upperbound"];
+            table_id t{code, scope, table};
+            const uint64_t key = *secondary;
+            return idx64_result( t, find_idx64_entry( t, [&](uint64_t s, uint64_t) { return s > key; } ), secondary, primary );
+         });
+      intrinsics::set_intrinsic<intrinsics::db_idx64_end>([](uint64_t code, uint64_t scope, uint64_t table) {
+         ++calls["db_idx64_end"];
+         return end_iterator( table_id{code, scope, table} );
+      });
+   }
+} // ns mock_db
@@ -0,0 +1,537 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/tester.hpp>
+
+#include "mock_db.hpp"
+
+using namespace eosio::native;
+using eosio::name;
+
+struct order {
+   uint64_t id;
+   uint64_t expires;
+   uint64_t amount;
+
+   uint64_t primary_key()const { return id; }
+   uint64_t by_expires()const { return expires; }
+
+   EOSLIB_SERIALIZE( order, (id)(expires)(amount) )
+};
+
+using orders_table = eosio::multi_index<"orders"_n, order,
+   eosio::indexed_by<"byexpires"_n, eosio::const_mem_fun<order, uint64_t, &order::by_expires>>>;
+
+struct entry {
+   uint64_t id;
+   uint64_t value;
+
+   uint64_t primary_key()const { return id; }
+
+   EOSLIB_SERIALIZE( entry, (id)(value) )
+};
+
+using entries_table = eosio::multi_index<"entries"_n, entry>;
+
+struct account {
+   uint64_t id;
+   name     owner;
+   uint64_t balance;
+
+   uint64_t primary_key()const { return id; }
+   uint64_t by_owner()const { return owner.value; }
+   uint64_t by_balance()const { return balance; }
+
+   EOSLIB_SERIALIZE( account, (id)(owner)(balance) )
+};
+
+using accounts_table = eosio::multi_index<"accounts"_n, account,
+   eosio::indexed_by<"byowner"_n, eosio::const_mem_fun<account, uint64_t, &account::by_owner>>,
+   eosio::indexed_by<"bybalance"_n, eosio::const_mem_fun<account, uint64_t, &account::by_balance>>>;
+
+constexpr name self{"self"};
+
+// orders 0 to n-1, order i expires at 1000 - 10*i
+static void add_orders( uint64_t n ) {
+   orders_table orders( self, self.value );
+   for( uint64_t i = 0; i < n; i++ )
+      orders.emplace( self, [&]( auto& o ) { o = order{i, 1000 - 10*i, i*100}; } );
+}
+
+static size_t live_rows() {
+   size_t n = 0;
+   for( const auto& r : mock_db::rows )
+      n += !r.removed;
+   return n;
+}
+
+static size_t live_secondary_keys() {
+   size_t n = 0;
+   for( const auto& e : mock_db::idx64_entries )
+      n += !e.removed;
+   return n;
+}
+
+// Secondary keys are stored, updated and removed for each index
+EOSIO_TEST_BEGIN(secondary_index_test)
+   mock_db::reset( self );
+   {
+      accounts_table accounts( self, self.value );
+      accounts.emplace( self, [&]( auto& a ) { a = account{1, "bob"_n, 50}; } );
+      accounts.emplace( self, [&]( auto& a ) { a = account{2, "alice"_n, 70}; } );
+      accounts.emplace( self, [&]( auto& a ) { a = account{3, "carol"_n, 10}; } );
+      CHECK_EQUAL( mock_db::calls["db_idx64_store"], 6 )
+      CHECK_EQUAL( accounts.available_primary_key(), 4 )
+   }
+   {
+      accounts_table accounts( self, self.value );
+      auto by_owner   = accounts.get_index<"byowner"_n>();
+      auto by_balance = accounts.get_index<"bybalance"_n>();
+      CHECK_EQUAL( by_owner.begin()->id, 2 )
+      CHECK_EQUAL( by_balance.begin()->id, 3 )
+      CHECK_EQUAL( by_owner.get( "bob"_n.value ).balance, 50 )
+
+      // only the secondary key which changed is updated
+      mock_db::calls.clear();
+      by_owner.modify( by_owner.find( "carol"_n.value ), self, [&]( auto& a ) { a.balance = 100; } );
+      CHECK_EQUAL( mock_db::calls["db_idx64_update"], 1 )
+      CHECK_EQUAL( (--by_balance.end())->owner, "carol"_n )
+
+      by_balance.erase( by_balance.begin() );
+      CHECK_EQUAL( live_rows(), 2 )
+      CHECK_EQUAL( live_secondary_keys(), 4 )
+      CHECK_EQUAL( by_owner.find( "bob"_n.value ) == by_owner.end(), true )
+   }
+   {
+      const accounts_table accounts( self, self.value );
+      auto by_balance = accounts.get_index<"bybalance"_n>();
+      CHECK_EQUAL( by_balance.begin()->owner, "alice"_n )
+      CHECK_EQUAL( accounts.get_index<"byowner"_n>().begin()->owner, "alice"_n )
+   }
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(range_test)
+   mock_db::reset( self );
+   add_orders( 10 );
+
+   // -----------------------------------------------------------
+   // void multi_index::for_each_range(uint64_t, uint64_t, Visitor)
+   {
+      orders_table orders( self, self.value );
+      std::vector<uint64_t> ids;
+      mock_db::calls.clear();
+      orders.for_each_range( 2, 5, [&]( const order& o ) { ids.push_back( o.id ); } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{2, 3, 4}) )
+      CHECK_EQUAL( mock_db::calls["db_find_i64"], 0 )
+      CHECK_EQUAL( mock_db::calls["db_next_i64"], 3 )
+
+      ids.clear();
+      orders.for_each_range( 8, 100, [&]( const order& o ) { ids.push_back( o.amount ); } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{800, 900}) )
+
+      ids.clear();
+      orders.for_each_range( 0, 100, [&]( const order& o ) { ids.push_back( o.id ); return o.id < 1; } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{0, 1}) )
+
+      ids.clear();
+      orders.for_each_range( 5, 5, [&]( const order& o ) { ids.push_back( o.id ); } );
+      orders.for_each_range( 6, 5, [&]( const order& o ) { ids.push_back( o.id ); } );
+      orders.for_each_range( 20, 30, [&]( const order& o ) { ids.push_back( o.id ); } );
+      CHECK_EQUAL( ids.size(), 0 )
+
+      // loaded objects are visited as they are
+      const auto& o = orders.get( 3 );
+      ids.clear();
+      orders.for_each_range( 3, 4, [&]( const order& v ) { ids.push_back( &v == &o ); } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{1}) )
+   }
+
+   // -------------------------------------------------------------------------------
+   // void multi_index::index::for_each_range(const key&, const key&, Visitor)const
+   {
+      const orders_table orders( self, self.value );
+      auto by_expires = orders.get_index<"byexpires"_n>();
+      std::vector<uint64_t> ids;
+      by_expires.for_each_range( 930, 971, [&]( const order& o ) { ids.push_back( o.id ); } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{7, 6, 5, 4, 3}) )
+      ids.clear();
+      by_expires.for_each_range( 0, 1000, [&]( const order& o ) { ids.push_back( o.id ); return ids.size() < 2; } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{9, 8}) )
+   }
+
+   // ---------------------------------------------------------------
+   // uint64_t multi_index::erase_range(uint64_t, uint64_t, uint64_t)
+   {
+      orders_table orders( self, self.value );
+      auto loaded = orders.find( 4 );
+      CHECK_EQUAL( loaded->id, 4 )
+
+      CHECK_EQUAL( orders.erase_range( 2, 5 ), 3 )
+      CHECK_EQUAL( live_rows(), 7 )
+      CHECK_EQUAL( live_secondary_keys(), 7 )
+      CHECK_EQUAL( orders.find( 2 ) == orders.end(), true )
+      CHECK_EQUAL( orders.find( 4 ) == orders.end(), true )
+      CHECK_EQUAL( orders.find( 5 )->id, 5 )
+      CHECK_EQUAL( orders.get_index<"byexpires"_n>().find( 970 ) == orders.get_index<"byexpires"_n>().end(), true )
+
+      CHECK_EQUAL( orders.erase_range( 0, 100, 2 ), 2 )
+      CHECK_EQUAL( orders.begin()->id, 5 )
+      CHECK_EQUAL( orders.erase_range( 7, 7 ), 0 )
+      CHECK_EQUAL( orders.erase_range( 20, 30 ), 0 )
+      CHECK_EQUAL( live_rows(), 5 )
+   }
+
+   // ----------------------------------------------------------------------------
+   // uint64_t multi_index::index::erase_range(const key&, const key&, uint64_t)
+   {
+      orders_table orders( self, self.value );
+      auto by_expires = orders.get_index<"byexpires"_n>();
+      // orders 8 and 9
+      CHECK_EQUAL( by_expires.erase_range( 0, 930 ), 2 )
+      CHECK_EQUAL( live_rows(), 3 )
+      CHECK_EQUAL( live_secondary_keys(), 3 )
+      std::vector<uint64_t> ids;
+      orders.for_each_range( 0, 100, [&]( const order& o ) { ids.push_back( o.id ); } );
+      CHECK_EQUAL( ids, (std::vector<uint64_t>{5, 6, 7}) )
+
+      CHECK_EQUAL( by_expires.erase_range( 0, 1000, 1 ), 1 )
+      CHECK_EQUAL( orders.begin()->id, 5 )
+      CHECK_EQUAL( by_expires.begin()->id, 6 )
+   }
+
+   // tables without secondary indices don't read what they erase
+   {
+      entries_table entries( self, self.value );
+      for( uint64_t i = 0; i < 5; i++ )
+         entries.emplace( self, [&]( auto& e ) { e = entry{i, i}; } );
+   }
+   {
+      entries_table entries( self, self.value );
+      mock_db::calls.clear();
+      CHECK_EQUAL( entries.erase_range( 1, 4 ), 3 )
+      CHECK_EQUAL( mock_db::calls["db_get_i64"], 0 )
+      CHECK_EQUAL( entries.begin()->id, 0 )
+      CHECK_EQUAL( (++entries.begin())->id, 4 )
+   }
+
+   CHECK_ASSERT( "cannot erase objects in table of another contract", []() {
+      orders_table( "other"_n, self.value ).erase_range( 0, 100 );
+   } )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(key_iterator_test)
+   mock_db::reset( self );
+   add_orders( 10 );
+
+   const orders_table orders( self, self.value );
+   auto by_expires = orders.get_index<"byexpires"_n>();
+   mock_db::calls.clear();
+
+   // ------------------------------------------------------------------
+   // key_iterator multi_index::index::keys_begin()const / keys_end()const
+   std::vector<uint64_t> secondary, primary;
+   for( auto itr = by_expires.keys_begin(); itr != by_expires.keys_end(); ++itr ) {
+      auto [expires, id] = *itr;
+      secondary.push_back( expires );
+      primary.push_back( id );
+   }
+   CHECK_EQUAL( secondary, (std::vector<uint64_t>{910, 920, 930, 940, 950, 960, 970, 980, 990, 1000}) )
+   CHECK_EQUAL( primary, (std::vector<uint64_t>{9, 8, 7, 6, 5, 4, 3, 2, 1, 0}) )
+   // the primary table is never touched
+   CHECK_EQUAL( mock_db::calls["db_find_i64"] + mock_db::calls["db_get_i64"], 0 )
+
+   // secondary keys are only looked up when needed
+   mock_db::calls.clear();
+   primary.clear();
+   for( auto itr = by_expires.keys_begin(); itr != by_expires.keys_end(); ++itr )
+      primary.push_back( itr.primary_key() );
+   CHECK_EQUAL( primary.size(), 10 )
+   CHECK_EQUAL( mock_db::calls["db_idx64_find_primary"], 0 )
+
+   // -----------------------------------------------------------------------------
+   // key_iterator multi_index::index::keys_lower_bound(const key&)const, keys_upper_bound(const key&)const
+   CHECK_EQUAL( by_expires.keys_lower_bound( 950 ).primary_key(), 5 )
+   CHECK_EQUAL( by_expires.keys_lower_bound( 951 ).secondary_key(), 960 )
+   CHECK_EQUAL( by_expires.keys_upper_bound( 950 ).primary_key(), 4 )
+   CHECK_EQUAL( by_expires.keys_lower_bound( 1001 ) == by_expires.keys_end(), true )
+   CHECK_EQUAL( by_expires.keys_upper_bound( 1000 ) == by_expires.keys_end(), true )
+
+   // top 3 by expiry, walking backwards
+   primary.clear();
+   secondary.clear();
+   for( auto itr = by_expires.keys_rbegin(); itr != by_expires.keys_rend() && primary.size() < 3; ++itr ) {
+      primary.push_back( (*itr).second );
+      secondary.push_back( (*itr).first );
+   }
+   CHECK_EQUAL( primary, (std::vector<uint64_t>{0, 1, 2}) )
+   CHECK_EQUAL( secondary, (std::vector<uint64_t>{1000, 990, 980}) )
+
+   auto last = by_expires.keys_end();
+   --last;
+   CHECK_EQUAL( last.primary_key(), 0 )
+   CHECK_EQUAL( (--last).secondary_key(), 990 )
+   CHECK_ASSERT( "cannot dereference end iterator", [&]() { by_expires.keys_end().primary_key(); } )
+   CHECK_ASSERT( "cannot increment end iterator", [&]() { ++by_expires.keys_end(); } )
+   CHECK_ASSERT( "cannot decrement iterator at beginning of index", [&]() { --by_expires.keys_begin(); } )
+
+   const orders_table empty( self, "empty"_n.value );
+   CHECK_EQUAL( empty.get_index<"byexpires"_n>().keys_begin() == empty.get_index<"byexpires"_n>().keys_end(), true )
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(auto_increment_test)
+   mock_db::reset( self );
+   const auto next_primary_key_row = [&]() -> uint64_t {
+      for( const auto& r : mock_db::rows ) {
+         if( !r.removed && r.table == "autoincr.key1"_n.value && r.primary_key == "entries"_n.value ) {
+            uint64_t next;
+            memcpy( &next, r.data.data(), sizeof(next) );
+            return next;
+         }
+      }
+      return 0;
+   };
+   const auto add_entry = []( entries_table& entries ) {
+      return entries.emplace( self, [&]( auto& e ) { e = entry{entries.available_primary_key(), 0}; } )->id;
+   };
+
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( add_entry( entries ), 0 )
+      CHECK_EQUAL( add_entry( entries ), 1 )
+      CHECK_EQUAL( add_entry( entries ), 2 )
+      CHECK_EQUAL( next_primary_key_row(), 3 )
+      CHECK_EQUAL( mock_db::calls["db_store_i64"], 4 )
+      CHECK_EQUAL( mock_db::calls["db_update_i64"], 2 )
+   }
+
+   // the next primary key is read without loading the last object of the table
+   mock_db::calls.clear();
+   {
+      const entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( entries.available_primary_key(), 3 )
+      CHECK_EQUAL( entries.available_primary_key(), 3 )
+      CHECK_EQUAL( mock_db::calls["db_find_i64"], 1 )
+      CHECK_EQUAL( mock_db::calls["db_get_i64"], 1 )
+      CHECK_EQUAL( mock_db::calls["db_lowerbound_i64"], 1 )
+      CHECK_EQUAL( mock_db::host_calls(), 3 )
+   }
+
+   // primary keys aren't reused
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      entries.erase_range( 0, 10 );
+      CHECK_EQUAL( add_entry( entries ), 3 )
+      entries.emplace( self, [&]( auto& e ) { e = entry{100, 0}; } );
+      CHECK_EQUAL( next_primary_key_row(), 101 )
+      // smaller primary keys don't change it
+      entries.emplace( self, [&]( auto& e ) { e = entry{50, 0}; } );
+      CHECK_EQUAL( next_primary_key_row(), 101 )
+      entries.erase( entries.get( 100 ) );
+   }
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( add_entry( entries ), 101 )
+   }
+   {
+      entries_table entries( self, self.value );
+      CHECK_EQUAL( entries.available_primary_key(), 102 )
+   }
+
+   // tables used without auto-increment before are probed once
+   mock_db::reset( self );
+   {
+      entries_table entries( self, self.value );
+      for( int i = 0; i < 5; i++ )
+         add_entry( entries );
+   }
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( add_entry( entries ), 5 )
+      CHECK_EQUAL( next_primary_key_row(), 6 )
+   }
+   mock_db::calls.clear();
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( add_entry( entries ), 6 )
+      CHECK_EQUAL( mock_db::calls["db_end_i64"] + mock_db::calls["db_previous_i64"], 0 )
+   }
+
+   // a row left behind by instances without auto-increment is repaired
+   {
+      entries_table entries( self, self.value );
+      CHECK_EQUAL( add_entry( entries ), 7 )
+      CHECK_EQUAL( add_entry( entries ), 8 )
+      CHECK_EQUAL( next_primary_key_row(), 7 )
+   }
+   {
+      entries_table entries( self, self.value, eosio::auto_increment );
+      CHECK_EQUAL( entries.available_primary_key(), 9 )
+      CHECK_EQUAL( add_entry( entries ), 9 )
+      CHECK_EQUAL( next_primary_key_row(), 10 )
+   }
+EOSIO_TEST_END
+
+struct blob {
+   uint64_t          id;
+   std::vector<char> data;
+
+   uint64_t primary_key()const { return id; }
+
+   EOSLIB_SERIALIZE( blob, (id)(data) )
+};
+
+using blobs_table = eosio::multi_index<"blobs"_n, blob>;
+
+EOSIO_TEST_BEGIN(row_read_test)
+   mock_db::reset( self );
+   // packed sizes are 10 + size, from 128 to 16383 bytes of data
+   const auto add_blob = []( uint64_t id, size_t size ) {
+      blobs_table blobs( self, self.value );
+      blobs.emplace( self, [&]( auto& b ) { b = blob{id, std::vector<char>(size, char(id))}; } );
+   };
+   constexpr size_t capacity = eosio::internal_use_do_not_use::read_buffer::initial_capacity;
+   add_blob( 1, 200 );
+   add_blob( 2, capacity - 10 );
+   add_blob( 3, 4000 );
+   add_blob( 4, 3000 );
+   add_blob( 5, 10000 );
+
+   const auto read = []( uint64_t id ) {
+      mock_db::calls.clear();
+      blobs_table blobs( self, self.value );
+      const auto& b = blobs.get( id );
+      CHECK_EQUAL( b.data.size() > 0 && b.data.front() == char(id) && b.data.back() == char(id), true )
+      return mock_db::calls["db_get_i64"];
+   };
+
+   // rows which fit are read at once
+   CHECK_EQUAL( read( 1 ), 1 )
+   // a row which fills the buffer needs its size to be checked
+   CHECK_EQUAL( read( 2 ), 2 )
+   // larger rows grow the buffer
+   CHECK_EQUAL( read( 3 ), 3 )
+   CHECK_EQUAL( read( 3 ), 1 )
+   CHECK_EQUAL( read( 4 ), 1 )
+   CHECK_EQUAL( read( 5 ), 3 )
+   CHECK_EQUAL( read( 1 ), 1 )
+   CHECK_EQUAL( read( 4 ), 1 )
+
+   std::vector<uint64_t> sizes;
+   blobs_table( self, self.value ).for_each_range( 0, 10, [&]( const blob& b ) { sizes.push_back( b.data.size() ); } );
+   CHECK_EQUAL( sizes, (std::vector<uint64_t>{200, capacity - 10, 4000, 3000, 10000}) )
+EOSIO_TEST_END
+
+// Host calls of expiring 99 of 100 orders, of finding the first 10 orders by expiry and of adding an order, and
+// cycles of scanning the table, run with -v to see the results
+EOSIO_TEST_BEGIN(multi_index_bench)
+   mock_db::reset( self );
+   add_orders( 100 );
+   mock_db::calls.clear();
+   {
+      orders_table orders( self, self.value );
+      auto by_expires = orders.get_index<"byexpires"_n>();
+      for( auto itr = by_expires.begin(); itr != by_expires.end() && itr->expires < 1000; )
+         itr = by_expires.erase( itr );
+   }
+   const size_t iterating_calls = mock_db::host_calls();
+
+   mock_db::reset( self );
+   add_orders( 100 );
+   mock_db::calls.clear();
+   {
+      orders_table orders( self, self.value );
+      orders.get_index<"byexpires"_n>().erase_range( 0, 1000 );
+   }
+   const size_t range_calls = mock_db::host_calls();
+   eosio::print("db host calls to expire 99 orders by iterating: ", iterating_calls, ", with erase_range: ", range_calls, "\n");
+   CHECK_EQUAL( live_rows(), 1 )
+   CHECK_EQUAL( range_calls < iterating_calls, true )
+
+   // top 10 by expiry
+   mock_db::reset( self );
+   add_orders( 100 );
+   std::vector<uint64_t> top;
+   mock_db::calls.clear();
+   {
+      const orders_table orders( self, self.value );
+      auto by_expires = orders.get_index<"byexpires"_n>();
+      for( auto itr = by_expires.begin(); itr != by_expires.end() && top.size() < 10; ++itr )
+         top.push_back( itr->id );
+   }
+   const size_t object_calls = mock_db::host_calls();
+   mock_db::calls.clear();
+   {
+      const orders_table orders( self, self.value );
+      auto by_expires = orders.get_index<"byexpires"_n>();
+      for( auto itr = by_expires.keys_begin(); itr != by_expires.keys_end() && top.size() < 20; ++itr )
+         top.push_back( itr.primary_key() );
+   }
+   const size_t key_calls = mock_db::host_calls();
+   eosio::print("db host calls for the top 10 by iterating objects: ", object_calls, ", by iterating keys: ", key_calls, "\n");
+   CHECK_EQUAL( std::equal( top.begin(), top.begin() + 10, top.begin() + 10 ), true )
+   CHECK_EQUAL( key_calls, 11 )
+
+   // adding an object with a new multi_index, as an action does
+   mock_db::reset( self );
+   add_orders( 100 );
+   mock_db::calls.clear();
+   {
+      orders_table orders( self, self.value );
+      orders.emplace( self, [&]( auto& o ) { o = order{orders.available_primary_key(), 0, 0}; } );
+   }
+   const size_t probing_calls = mock_db::host_calls();
+   {
+      orders_table orders( self, self.value, eosio::auto_increment );
+      orders.emplace( self, [&]( auto& o ) { o = order{orders.available_primary_key(), 0, 0}; } );
+   }
+   mock_db::calls.clear();
+   {
+      orders_table orders( self, self.value, eosio::auto_increment );
+      orders.emplace( self, [&]( auto& o ) { o = order{orders.available_primary_key(), 0, 0}; } );
+   }
+   const size_t auto_increment_calls = mock_db::host_calls();
+   eosio::print("db host calls to emplace with available_primary_key: ", probing_calls, ", in auto-increment mode: ", auto_increment_calls, "\n");
+   CHECK_EQUAL( orders_table( self, self.value ).available_primary_key(), 103 )
+   // find, get and lowerbound on the row of the key, then the store and its update, instead of end, previous and
+   // reading the last object before the store
+   CHECK_EQUAL( probing_calls, 7 )
+   CHECK_EQUAL( auto_increment_calls, 6 )
+
+   EOSIO_BENCH( "for_each_range", 100,
+      uint64_t total = 0;
+      orders_table( self, self.value ).for_each_range( 0, 100, [&]( const order& o ) { total += o.amount; } );
+      bench_do_not_optimize( total );
+   )
+   EOSIO_BENCH( "iterating", 100,
+      uint64_t total = 0;
+      orders_table orders( self, self.value );
+      for( const auto& o : orders )
+         total += o.amount;
+      bench_do_not_optimize( total );
+   )
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   mock_db::install();
+
+   EOSIO_TEST(secondary_index_test);
+   EOSIO_TEST(range_test);
+   EOSIO_TEST(key_iterator_test);
+   EOSIO_TEST(auto_increment_test);
+   EOSIO_TEST(row_read_test);
+   EOSIO_TEST(multi_index_bench);
+   return has_failed();
+}
@@ -253,6 +253,31 @@ EOSIO_TEST_BEGIN(name_type_test)
    CHECK_EQUAL( name{"aaaaaaaaaaaaj"}.to_string(), "aaaaaaaaaaaaj" )
    CHECK_EQUAL( name{"zzzzzzzzzzzzj"}.to_string(), "zzzzzzzzzzzzj" )
 
+   // -------------------------------------------------
+   // constexpr std::array<char, 13> to_char_array()const
+   auto char_array_str = [](name n) {
+      auto chars = n.to_char_array();
+      return string{chars.data(), strnlen(chars.data(), chars.size())};
+   };
+   CHECK_EQUAL( char_array_str(name{""}), "" )
+   CHECK_EQUAL( char_array_str(name{"a"}), "a" )
+   CHECK_EQUAL( char_array_str(name{".abc"}), ".abc" )
+   CHECK_EQUAL( char_array_str(name{"123."}), "123" )
+   CHECK_EQUAL( char_array_str(name{".a.b.c.1.2.3."}), ".a.b.c.1.2.3" )
+   CHECK_EQUAL( char_array_str(name{"eosioaccount"}), "eosioaccount" )
+   CHECK_EQUAL( char_array_str(name{"tuvwxyz.1234j"}), "tuvwxyz.1234j" )
+   CHECK_EQUAL( char_array_str(name{"zzzzzzzzzzzzj"}), "zzzzzzzzzzzzj" )
+   static_assert( "eosio.token"_n.to_char_array()[5] == '.' );
+   static_assert( "eosio.token"_n.to_char_array()[11] == '\0' );
+
+   // every 5-bit value of every position decodes and encodes back to itself
+   for( uint32_t pos = 0; pos < 13; ++pos ) {
+      for( uint64_t v = 0; v < (pos == 12 ? 16 : 32); ++v ) {
+         name n{ pos == 12 ? v | (1ULL << 59) : (v << (59 - 5*pos)) | 1ULL };
+         CHECK_EQUAL( name{n.to_string()}, n )
+      }
+   }
+
    // ----------------------------------------------------------
    // friend constexpr bool operator==(const name&, const name&)
    CHECK_EQUAL( name{"1"} == name{"1"}, true )
@@ -368,6 +393,36 @@ EOSIO_TEST_BEGIN(name_type_test)
    CHECK_EQUAL( name{"zzzzzzzzzzzzj"}, "zzzzzzzzzzzzj"_n )
 EOSIO_TEST_END
 
+// Bulk conversions between names and strings, run with -v to see the results
+EOSIO_TEST_BEGIN(name_bench)
+   static const char* const names[] = {"eosio", "eosio.token", "alice", "bob.x", "zzzzzzzzzzzzj", "1", "exchange.abc", "a.b.c.d"};
+   static constexpr uint64_t num_names = sizeof(names) / sizeof(names[0]);
+
+   EOSIO_BENCH( "name(string_view)", 100000,
+      name n{std::string_view{names[__bench_i % num_names]}};
+      bench_do_not_optimize(n);
+   )
+   const name n{"exchange.abc"};
+   EOSIO_BENCH( "name::length", 100000,
+      auto l = name{n.value + __bench_i}.length();
+      bench_do_not_optimize(l);
+   )
+   EOSIO_BENCH( "name::write_as_string", 100000,
+      char buffer[13];
+      auto end = name{n.value + __bench_i}.write_as_string( buffer, buffer + sizeof(buffer) );
+      bench_do_not_optimize(end);
+   )
+   EOSIO_BENCH( "name::to_char_array", 100000,
+      auto chars = name{n.value + __bench_i}.to_char_array();
+      bench_do_not_optimize(chars);
+   )
+   EOSIO_BENCH( "name::to_string", 100000,
+      auto str = name{n.value + __bench_i}.to_string();
+      bench_do_not_optimize(str);
+   )
+   CHECK_EQUAL( n.to_string(), "exchange.abc" )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -376,5 +431,6 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(name_type_test);
+   EOSIO_TEST(name_bench);
    return has_failed();
 }
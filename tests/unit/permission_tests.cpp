@@ -0,0 +1,105 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/permission.hpp>
+#include <eosio/tester.hpp>
+
+#include <array>
+#include <set>
+#include <vector>
+
+using namespace eosio::native;
+using eosio::permission_level;
+using eosio::public_key;
+
+// arguments of the last authorization check the contract made
+static std::vector<char> last_trx, last_keys, last_perms;
+static const char* last_buffer = nullptr;
+static uint64_t last_delay = 0;
+
+static void record(std::vector<char>& v, const char* data, uint32_t size) {
+   v.assign(data, data + size);
+}
+
+static eosio::transaction make_transaction() {
+   eosio::transaction trx(eosio::time_point_sec(1000));
+   trx.actions.emplace_back(std::vector<permission_level>{{"alice"_n, "active"_n}}, "eosio.token"_n, "transfer"_n, std::string("payload"));
+   return trx;
+}
+
+static public_key make_key(char c) {
+   return public_key(std::in_place_index<0>, std::array<char, 33>{c});
+}
+
+EOSIO_TEST_BEGIN(authorization_span_test)
+   intrinsics::set_intrinsic<intrinsics::check_transaction_authorization>([](const char* trx, uint32_t trx_size, const char* keys, uint32_t keys_size,
+                                                                             const char* perms, uint32_t perms_size) {
+      record(last_trx, trx, trx_size);
+      record(last_keys, keys, keys_size);
+      record(last_perms, perms, perms_size);
+      last_buffer = trx;
+      return 1;
+   });
+   intrinsics::set_intrinsic<intrinsics::check_permission_authorization>([](uint64_t, uint64_t, const char* keys, uint32_t keys_size,
+                                                                            const char* perms, uint32_t perms_size, uint64_t delay) {
+      record(last_keys, keys, keys_size);
+      record(last_perms, perms, perms_size);
+      last_buffer = keys;
+      last_delay = delay;
+      return 1;
+   });
+
+   const eosio::transaction trx = make_transaction();
+   const std::vector<permission_level> perms = {{"alice"_n, "active"_n}, {"bob"_n, "owner"_n}};
+   const std::array<public_key, 2> keys = {make_key(1), make_key(2)};
+
+   // ranges are packed exactly like the sets they replace
+   CHECK_EQUAL( eosio::check_transaction_authorization(trx, std::set<permission_level>(perms.begin(), perms.end()),
+                                                       std::set<public_key>(keys.begin(), keys.end())), true )
+   const auto set_trx = last_trx, set_keys = last_keys, set_perms = last_perms;
+   CHECK_EQUAL( eosio::check_transaction_authorization(trx, perms, keys), true )
+   CHECK_EQUAL( last_trx == set_trx, true )
+   CHECK_EQUAL( last_keys == set_keys, true )
+   CHECK_EQUAL( last_perms == set_perms, true )
+
+   // empty ranges are not passed to the intrinsic
+   CHECK_EQUAL( eosio::check_transaction_authorization(trx, perms), true )
+   CHECK_EQUAL( last_keys.size(), 0 )
+   CHECK_EQUAL( last_perms == set_perms, true )
+
+   CHECK_EQUAL( eosio::check_permission_authorization("alice"_n, "active"_n, keys, perms, eosio::microseconds{5}), true )
+   CHECK_EQUAL( last_keys == set_keys, true )
+   CHECK_EQUAL( last_perms == set_perms, true )
+   CHECK_EQUAL( last_delay, 5 )
+   CHECK_EQUAL( eosio::check_permission_authorization("alice"_n, "active"_n, keys), true )
+   CHECK_EQUAL( last_keys == set_keys, true )
+   CHECK_EQUAL( last_perms.size(), 0 )
+
+   // every check packs into the same buffer once it is large enough
+   eosio::check_transaction_authorization(trx, perms, keys);
+   const char* buffer = last_buffer;
+   for (int i = 0; i < 10; i++) {
+      eosio::check_transaction_authorization(trx, perms, keys);
+      CHECK_EQUAL( last_buffer == buffer, true )
+      eosio::check_permission_authorization("alice"_n, "active"_n, keys, perms);
+      CHECK_EQUAL( last_buffer == buffer, true )
+   }
+
+   CHECK_ASSERT( "negative delay is not allowed", [&]() {
+      eosio::check_permission_authorization("alice"_n, "active"_n, keys, perms, eosio::microseconds{-1});
+   })
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(authorization_span_test);
+   return has_failed();
+}
@@ -0,0 +1,108 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#define EOSIO_PRINT_BUFFER
+#define EOSIO_PRINT_BUFFER_SIZE 64
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/tester.hpp>
+
+using namespace eosio::native;
+using eosio::print_buffer;
+
+// number of print intrinsics called, i.e. of host calls a contract makes
+static size_t host_calls = 0;
+
+template <intrinsics::intrinsic_name Intrinsic>
+void count_calls() {
+   auto intrinsic = intrinsics::get_intrinsic<Intrinsic>();
+   intrinsics::set_intrinsic<Intrinsic>([intrinsic](auto... args) {
+      ++host_calls;
+      intrinsic(args...);
+   });
+}
+
+EOSIO_TEST_BEGIN(print_buffer_test)
+   // nothing reaches the console until the buffer is flushed
+   host_calls = 0;
+   eosio::print("buffered ", 42);
+   CHECK_EQUAL( host_calls, 0 )
+   CHECK_PRINT("buffered 42", [](){ print_buffer::flush(); });
+   CHECK_EQUAL( host_calls, 1 )
+
+   // values are formatted the same way the intrinsics format them
+   CHECK_PRINT("27", [](){ eosio::print((uint8_t)27); print_buffer::flush(); });
+   CHECK_PRINT("-202", [](){ eosio::print((int)-202); print_buffer::flush(); });
+   CHECK_PRINT("18446744073709551615", [](){ eosio::print(UINT64_MAX); print_buffer::flush(); });
+   CHECK_PRINT("-9223372036854775808", [](){ eosio::print(INT64_MIN); print_buffer::flush(); });
+   CHECK_PRINT("0", [](){ eosio::print(0u); print_buffer::flush(); });
+   CHECK_PRINT("true false", [](){ eosio::print(true, " ", false); print_buffer::flush(); });
+   CHECK_PRINT("c", [](){ eosio::print('c'); print_buffer::flush(); });
+   CHECK_PRINT("eosio.token", [](){ eosio::print("eosio.token"_n); print_buffer::flush(); });
+   CHECK_PRINT("", [](){ eosio::print(eosio::name{}); print_buffer::flush(); });
+   CHECK_PRINT("00ff7f", [](){ uint8_t b[] = {0x00, 0xff, 0x7f}; eosio::printhex(b, sizeof(b)); print_buffer::flush(); });
+   CHECK_PRINT("1.0000 EOS", [](){ eosio::print(eosio::asset{10000, eosio::symbol{"EOS", 4}}); print_buffer::flush(); });
+   CHECK_PRINT("Number of apples: 10", [](){ eosio::print_f("Number of apples: %", 10); print_buffer::flush(); });
+
+   // 128-bit integers and floats still use their intrinsics, after what was buffered before them
+   CHECK_PRINT("a 0x0066000000000000", [](){ eosio::print("a ", (uint128_t)102); });
+
+   // the buffer is written when it is full and output longer than the buffer is written directly
+   host_calls = 0;
+   CHECK_PRINT("0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789", [](){
+      for (int i = 0; i < 100; i++)
+         eosio::print(i % 10);
+      print_buffer::flush();
+   });
+   CHECK_EQUAL( host_calls, 2 )
+
+   host_calls = 0;
+   CHECK_PRINT("short and a string which is longer than the 64 bytes the buffer holds in this test", [](){
+      eosio::print("short and ");
+      eosio::print("a string which is longer than the 64 bytes the buffer holds in this test");
+      print_buffer::flush();
+   });
+   CHECK_EQUAL( host_calls, 2 )
+
+   // a failing check writes the buffer before asserting
+   CHECK_PRINT("before the assert", [](){
+      eosio::print("before the assert");
+      expect_assert(true, "", "failed", [](){ eosio::check(false, "failed"); });
+   });
+EOSIO_TEST_END
+
+// Host calls made by a debug print of an action, which doesn't fit in the 64 byte buffer of this test,
+// run with -v to see the results
+EOSIO_TEST_BEGIN(print_buffer_bench)
+   host_calls = 0;
+   CHECK_PRINT("transfer from alice to bob of 1.0000 EOS (10000 units), memo: hi\n", [](){
+      eosio::print("transfer from ", "alice"_n, " to ", "bob"_n, " of ", eosio::asset{10000, eosio::symbol{"EOS", 4}},
+                   " (", 10000, " units), memo: ", "hi", "\n");
+      print_buffer::flush();
+   });
+   eosio::print("print host calls with the buffer: ", host_calls, " (without: 11)\n");
+   CHECK_EQUAL( host_calls, 2 )
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   count_calls<intrinsics::prints>();
+   count_calls<intrinsics::prints_l>();
+   count_calls<intrinsics::printi>();
+   count_calls<intrinsics::printui>();
+   count_calls<intrinsics::printn>();
+   count_calls<intrinsics::printhex>();
+
+   EOSIO_TEST(print_buffer_test);
+   EOSIO_TEST(print_buffer_bench);
+   print_buffer::flush();
+   return has_failed();
+}
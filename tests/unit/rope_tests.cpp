@@ -63,6 +63,68 @@ EOSIO_TEST_BEGIN(rope_test)
    for (int i=0; i < s3.length(); i++) {
       REQUIRE_EQUAL(s3[i], r3[i]);
    }
+
+   // flattening again only has to pick up the new appends
+   r3 += ", appended after c_str";
+   s3 += ", appended after c_str";
+   r3.append("literal");
+   s3 += "literal";
+   REQUIRE_EQUAL(s3.compare(r3.c_str()), 0);
+   REQUIRE_EQUAL(r3.sv().size(), s3.size());
+
+   // copies don't depend on the rope they were copied from
+   eosio::rope r4("");
+   {
+      std::string tmp = "short copied string";
+      eosio::rope copied(tmp.c_str());
+      r4 = copied;
+   }
+   REQUIRE_EQUAL(std::string(r4.c_str()), "short copied string");
+   REQUIRE_EQUAL(r4[100], '\0');
+
+   // the contents are printed by one host call however many leaves they span
+   size_t prints_calls = 0;
+   std::string printed;
+   intrinsics::set_intrinsic<intrinsics::prints_l>([&](const char* cs, uint32_t l) {
+      ++prints_calls;
+      printed.append(cs, l);
+   });
+   r2.print();
+   REQUIRE_EQUAL(prints_calls, 1);
+   REQUIRE_EQUAL(printed, s2);
+   intrinsics::set_intrinsic<intrinsics::prints_l>([](const char* cs, uint32_t l) {
+      _prints_l(cs, l, eosio::cdt::output_stream_kind::std_out);
+   });
+
+   char* flat = r2.c_str();
+   REQUIRE_EQUAL(std::string(flat), s2);
+EOSIO_TEST_END
+
+// Compares many short appends to a rope with std::string concatenation, run with -v to see the results
+EOSIO_TEST_BEGIN(rope_bench)
+   static const char* words[] = { "memo", ":", "transfer", " ", "of", " ", "1.0000 EOS", " ", "to", " ", "alice" };
+   static constexpr size_t num_words = sizeof(words) / sizeof(words[0]);
+
+   EOSIO_BENCH( "rope 256 short appends and c_str", 1000,
+      eosio::rope r;
+      for (size_t i = 0; i < 256; i++)
+         r += words[i % num_words];
+      bench_do_not_optimize(*r.c_str());
+   )
+   EOSIO_BENCH( "std::string 256 short appends", 1000,
+      std::string s;
+      for (size_t i = 0; i < 256; i++)
+         s += words[i % num_words];
+      bench_do_not_optimize(*s.c_str());
+   )
+
+   eosio::rope r;
+   std::string s;
+   for (size_t i = 0; i < 256; i++) {
+      r += words[i % num_words];
+      s += words[i % num_words];
+   }
+   REQUIRE_EQUAL(s.compare(r.c_str()), 0);
 EOSIO_TEST_END
 
 int main(int argc, char** argv) {
@@ -73,5 +135,6 @@ int main(int argc, char** argv) {
    silence_output(!verbose);
 
    EOSIO_TEST(rope_test);
+   EOSIO_TEST(rope_bench);
    return has_failed();
 }
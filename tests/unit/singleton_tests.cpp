@@ -0,0 +1,166 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/tester.hpp>
+
+#include "mock_db.hpp"
+
+using namespace eosio::native;
+using eosio::name;
+
+struct config {
+   name     admin;
+   uint64_t fee    = 0;
+   bool     paused = false;
+
+   EOSLIB_SERIALIZE( config, (admin)(fee)(paused) )
+};
+
+using config_singleton = eosio::singleton<"config"_n, config>;
+using cached_config    = eosio::cached_singleton<"config"_n, config>;
+
+constexpr name self{"self"};
+constexpr name other{"other"};
+
+EOSIO_TEST_BEGIN(cached_singleton_test)
+   mock_db::reset( self );
+
+   // nothing is read until it is needed
+   {
+      cached_config c( self, self.value );
+      CHECK_EQUAL( mock_db::host_calls(), 0 )
+      CHECK_EQUAL( c.exists(), false )
+      CHECK_EQUAL( c.get_or_default( config{"alice"_n} ).admin, "alice"_n )
+      CHECK_ASSERT( "singleton does not exist", [&]() { c.get(); } )
+      CHECK_EQUAL( mock_db::calls["db_find_i64"], 1 )
+      CHECK_EQUAL( c.dirty(), false )
+   }
+   CHECK_EQUAL( mock_db::rows.size(), 0 )
+
+   // a new value is stored once, when the singleton is destroyed
+   {
+      cached_config c( self, self.value );
+      c.get_or_create( self, config{"alice"_n, 10} );
+      c.modify( self ).fee = 20;
+      CHECK_EQUAL( c.dirty(), true )
+      CHECK_EQUAL( c.exists(), true )
+      CHECK_EQUAL( mock_db::rows.size(), 0 )
+   }
+   CHECK_EQUAL( mock_db::calls["db_store_i64"], 1 )
+   CHECK_EQUAL( mock_db::rows.size(), 1 )
+   CHECK_EQUAL( mock_db::rows[0].payer, self.value )
+
+   // the row is the one `singleton` reads and writes
+   {
+      config_singleton s( self, self.value );
+      CHECK_EQUAL( s.get().admin, "alice"_n )
+      CHECK_EQUAL( s.get().fee, 20 )
+      s.set( config{"bob"_n, 30, true}, self );
+   }
+
+   // a changed value is updated once, with the last payer
+   mock_db::calls.clear();
+   {
+      cached_config c( self, self.value );
+      CHECK_EQUAL( c.get().admin, "bob"_n )
+      CHECK_EQUAL( c.get().fee, 30 )
+      CHECK_EQUAL( c.get().paused, true )
+      c.set( config{"carol"_n, 1}, self );
+      c.modify( "carol"_n ).fee += 1;
+      c.modify( "carol"_n ).paused = true;
+      CHECK_EQUAL( c.get().fee, 2 )
+      c.flush();
+      CHECK_EQUAL( c.dirty(), false )
+      c.flush();
+   }
+   CHECK_EQUAL( mock_db::calls["db_find_i64"], 1 )
+   CHECK_EQUAL( mock_db::calls["db_get_i64"], 1 )
+   CHECK_EQUAL( mock_db::calls["db_update_i64"], 1 )
+   CHECK_EQUAL( mock_db::host_calls(), 3 )
+   CHECK_EQUAL( mock_db::rows[0].payer, "carol"_n.value )
+   {
+      config_singleton s( self, self.value );
+      CHECK_EQUAL( s.get().admin, "carol"_n )
+      CHECK_EQUAL( s.get().fee, 2 )
+   }
+
+   // reading doesn't write
+   mock_db::calls.clear();
+   {
+      cached_config c( self, self.value );
+      CHECK_EQUAL( c.get().admin, "carol"_n )
+   }
+   CHECK_EQUAL( mock_db::calls["db_update_i64"], 0 )
+
+   // removing isn't deferred, and drops pending changes
+   {
+      cached_config c( self, self.value );
+      c.modify( self ).fee = 100;
+      c.remove();
+      CHECK_EQUAL( c.exists(), false )
+      CHECK_EQUAL( mock_db::calls["db_remove_i64"], 1 )
+   }
+   CHECK_EQUAL( config_singleton( self, self.value ).exists(), false )
+
+   // only the receiver can change its tables
+   {
+      cached_config c( other, other.value );
+      CHECK_ASSERT( "cannot modify objects in table of another contract", [&]() { c.set( config{}, self ); } )
+      CHECK_EQUAL( c.dirty(), false )
+   }
+EOSIO_TEST_END
+
+// Host calls and cycles of an action which reads its config twice and changes it twice,
+// run with -v to see the results
+EOSIO_TEST_BEGIN(cached_singleton_bench)
+   mock_db::reset( self );
+   config_singleton( self, self.value ).set( config{"alice"_n, 10}, self );
+
+   auto with_singleton = []() {
+      config_singleton s( self, self.value );
+      auto cfg = s.get();
+      eosio::check( !cfg.paused, "paused" );
+      cfg.fee += 1;
+      s.set( cfg, self );
+      cfg.admin = s.get().admin;
+      s.set( cfg, self );
+   };
+   auto with_cached_singleton = []() {
+      cached_config c( self, self.value );
+      eosio::check( !c.get().paused, "paused" );
+      c.modify( self ).fee += 1;
+      c.modify( self ).admin = c.get().admin;
+   };
+
+   mock_db::calls.clear();
+   with_singleton();
+   const size_t singleton_calls = mock_db::host_calls();
+   mock_db::calls.clear();
+   with_cached_singleton();
+   const size_t cached_calls = mock_db::host_calls();
+   eosio::print("db host calls with singleton: ", singleton_calls, ", with cached_singleton: ", cached_calls, "\n");
+   CHECK_EQUAL( cached_calls, 3 )
+   CHECK_EQUAL( cached_calls < singleton_calls, true )
+
+   EOSIO_BENCH( "singleton", 1000, with_singleton(); )
+   EOSIO_BENCH( "cached_singleton", 1000, with_cached_singleton(); )
+   CHECK_EQUAL( config_singleton( self, self.value ).get().fee, 2012 )
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   mock_db::install();
+
+   EOSIO_TEST(cached_singleton_test);
+   EOSIO_TEST(cached_singleton_bench);
+   return has_failed();
+}
@@ -13,6 +13,27 @@ using std::move;
 using eosio::datastream;
 using eosio::string;
 
+// Counts the heap allocations made by the benchmarks
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+   ++allocations;
+   return malloc(size);
+}
+
+void* operator new[](size_t size) {
+   ++allocations;
+   return malloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+   free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+   free(ptr);
+}
+
 // Definitions found in `eosio.cdt/libraries/eosiolib/core/eosio/string.hpp`
 EOSIO_TEST_BEGIN(string_test)
    //// template <size_t N>
@@ -22,11 +43,11 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr1{"abcdef"};
 
       CHECK_EQUAL( eostr0.size(), 1 )
-      CHECK_EQUAL( eostr0.capacity(), 1 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), "a"), 0 )
 
       CHECK_EQUAL( eostr1.size(), 6 )
-      CHECK_EQUAL( eostr1.capacity(), 6 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "abcdef"), 0)
    }
 
@@ -35,7 +56,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr{};
 
       CHECK_EQUAL( eostr.size(), 0 )
-      CHECK_EQUAL( eostr.capacity(), 0 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), ""), 0)
    }
 
@@ -50,15 +71,15 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr2(str2, 6);
 
       CHECK_EQUAL( eostr0.size(), 0 )
-      CHECK_EQUAL( eostr0.capacity(), 0 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1.size(), 1 )
-      CHECK_EQUAL( eostr1.capacity(), 2 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr2.size(), 6 )
-      CHECK_EQUAL( eostr2.capacity(), 12 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "abcdef"), 0)
    }
 
@@ -69,15 +90,15 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr2(3, 'c');
 
       CHECK_EQUAL( eostr0.size(), 0 )
-      CHECK_EQUAL( eostr0.capacity(), 0 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1.size(), 1 )
-      CHECK_EQUAL( eostr1.capacity(), 2 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "c"), 0)
 
       CHECK_EQUAL( eostr2.size(), 3 )
-      CHECK_EQUAL( eostr2.capacity(), 6 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "ccc"), 0)
    }
 
@@ -95,39 +116,39 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr8_sub(eostr, 3, 2);
 
       CHECK_EQUAL( eostr0_sub.size(), 0 )
-      CHECK_EQUAL( eostr0_sub.capacity(), 0 )
+      CHECK_EQUAL( eostr0_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_sub.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1_sub.size(), 0 )
-      CHECK_EQUAL( eostr1_sub.capacity(), 0 )
+      CHECK_EQUAL( eostr1_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_sub.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr2_sub.size(), 1 )
-      CHECK_EQUAL( eostr2_sub.capacity(), 2 )
+      CHECK_EQUAL( eostr2_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2_sub.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr3_sub.size(), 3 )
-      CHECK_EQUAL( eostr3_sub.capacity(), 6 )
+      CHECK_EQUAL( eostr3_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr3_sub.c_str(), "abc"), 0)
 
       CHECK_EQUAL( eostr4_sub.size(), 6 )
-      CHECK_EQUAL( eostr4_sub.capacity(), 12 )
+      CHECK_EQUAL( eostr4_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr4_sub.c_str(), "abcdef"), 0)
 
       CHECK_EQUAL( eostr5_sub.size(), 6 )
-      CHECK_EQUAL( eostr5_sub.capacity(), 12 )
+      CHECK_EQUAL( eostr5_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr5_sub.c_str(), "abcdef"), 0)
 
       CHECK_EQUAL( eostr6_sub.size(), 6 )
-      CHECK_EQUAL( eostr6_sub.capacity(), 12 )
+      CHECK_EQUAL( eostr6_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr6_sub.c_str(), "abcdef"), 0 )
 
       CHECK_EQUAL( eostr7_sub.size(), 3 )
-      CHECK_EQUAL( eostr7_sub.capacity(), 6 )
+      CHECK_EQUAL( eostr7_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr7_sub.c_str(), "def"), 0 )
 
       CHECK_EQUAL( eostr8_sub.size(), 2 )
-      CHECK_EQUAL( eostr8_sub.capacity(), 4 )
+      CHECK_EQUAL( eostr8_sub.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr8_sub.c_str(), "de"), 0)
    }
 
@@ -141,15 +162,15 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr2_cpy{eostr2};
 
       CHECK_EQUAL( eostr0_cpy.size(), 0 )
-      CHECK_EQUAL( eostr0_cpy.capacity(), 0 )
+      CHECK_EQUAL( eostr0_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_cpy.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1_cpy.size(), 1 )
-      CHECK_EQUAL( eostr1_cpy.capacity(), 1 )
+      CHECK_EQUAL( eostr1_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_cpy.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr2_cpy.size(), 6 )
-      CHECK_EQUAL( eostr2_cpy.capacity(), 6 )
+      CHECK_EQUAL( eostr2_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2_cpy.c_str(), "abcdef"), 0)
    }
 
@@ -162,11 +183,11 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr1_cpy{eostr1};
 
       CHECK_EQUAL( eostr0_cpy.size(), 1 )
-      CHECK_EQUAL( eostr0_cpy.capacity(), 2 )
+      CHECK_EQUAL( eostr0_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_cpy.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr1_cpy.size(), 6 )
-      CHECK_EQUAL( eostr1_cpy.capacity(), 12 )
+      CHECK_EQUAL( eostr1_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_cpy.c_str(), "abcdef"), 0)
    }
 
@@ -180,15 +201,15 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr2_mv{move(eostr2)};
 
       CHECK_EQUAL( eostr0_mv.size(), 0 )
-      CHECK_EQUAL( eostr0_mv.capacity(), 0 )
+      CHECK_EQUAL( eostr0_mv.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1_mv.size(), 1 )
-      CHECK_EQUAL( eostr1_mv.capacity(), 1 )
+      CHECK_EQUAL( eostr1_mv.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr2_mv.size(), 6 )
-      CHECK_EQUAL( eostr2_mv.capacity(), 6 )
+      CHECK_EQUAL( eostr2_mv.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "abcdef"), 0)
    }
 
@@ -201,11 +222,11 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr1_cpy{move(eostr1)};
 
       CHECK_EQUAL( eostr0_cpy.size(), 1 )
-      CHECK_EQUAL( eostr0_cpy.capacity(), 2 )
+      CHECK_EQUAL( eostr0_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_cpy.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr1_cpy.size(), 6 )
-      CHECK_EQUAL( eostr1_cpy.capacity(), 12 )
+      CHECK_EQUAL( eostr1_cpy.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_cpy.c_str(), "abcdef"), 0)
    }
 
@@ -222,15 +243,15 @@ EOSIO_TEST_BEGIN(string_test)
       eostr2_cpy_assig = eostr2;
 
       CHECK_EQUAL( eostr0_cpy_assig.size(), 0 )
-      CHECK_EQUAL( eostr0_cpy_assig.capacity(), 0 )
+      CHECK_EQUAL( eostr0_cpy_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_cpy_assig.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1_cpy_assig.size(), 1 )
-      CHECK_EQUAL( eostr1_cpy_assig.capacity(), 1 )
+      CHECK_EQUAL( eostr1_cpy_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_cpy_assig.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr2_cpy_assig.size(), 6 )
-      CHECK_EQUAL( eostr2_cpy_assig.capacity(), 6 )
+      CHECK_EQUAL( eostr2_cpy_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2_cpy_assig.c_str(), "abcdef"), 0)
    }
 
@@ -245,11 +266,11 @@ EOSIO_TEST_BEGIN(string_test)
       eostr1_cpy_assig = eostr1;
 
       CHECK_EQUAL( eostr0_cpy_assig.size(), 1 )
-      CHECK_EQUAL( eostr0_cpy_assig.capacity(), 2 )
+      CHECK_EQUAL( eostr0_cpy_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_cpy_assig.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr1_cpy_assig.size(), 6 )
-      CHECK_EQUAL( eostr1_cpy_assig.capacity(), 12 )
+      CHECK_EQUAL( eostr1_cpy_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_cpy_assig.c_str(), "abcdef"), 0)
    }
 
@@ -266,15 +287,15 @@ EOSIO_TEST_BEGIN(string_test)
       eostr2_mv_assig = move(eostr2);
 
       CHECK_EQUAL( eostr0_mv_assig.size(), 0 )
-      CHECK_EQUAL( eostr0_mv_assig.capacity(), 0 )
+      CHECK_EQUAL( eostr0_mv_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_mv_assig.c_str(), ""), 0)
 
       CHECK_EQUAL( eostr1_mv_assig.size(), 1 )
-      CHECK_EQUAL( eostr1_mv_assig.capacity(), 1 )
+      CHECK_EQUAL( eostr1_mv_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_mv_assig.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr2_mv_assig.size(), 6 )
-      CHECK_EQUAL( eostr2_mv_assig.capacity(), 6 )
+      CHECK_EQUAL( eostr2_mv_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2_mv_assig.c_str(), "abcdef"), 0)
    }
 
@@ -289,11 +310,11 @@ EOSIO_TEST_BEGIN(string_test)
       eostr1_mv_assig = move(eostr1);
 
       CHECK_EQUAL( eostr0_mv_assig.size(), 1 )
-      CHECK_EQUAL( eostr0_mv_assig.capacity(), 2 )
+      CHECK_EQUAL( eostr0_mv_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0_mv_assig.c_str(), "a"), 0)
 
       CHECK_EQUAL( eostr1_mv_assig.size(), 6 )
-      CHECK_EQUAL( eostr1_mv_assig.capacity(), 12 )
+      CHECK_EQUAL( eostr1_mv_assig.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1_mv_assig.c_str(), "abcdef"), 0)
    }
 
@@ -303,12 +324,12 @@ EOSIO_TEST_BEGIN(string_test)
       eostr = "abcdef";
 
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdef"), 0 )
 
       eostr = eostr;
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdef"), 0 )
    }
 
@@ -318,12 +339,12 @@ EOSIO_TEST_BEGIN(string_test)
       eostr += "abcdef";
 
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdef"), 0 )
 
       eostr = eostr;
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdef"), 0 )
    }
 
@@ -436,7 +457,7 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr{"abcdef"};
       char* iter{eostr.begin()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), iter), 0 )
    }
 
@@ -445,7 +466,7 @@ EOSIO_TEST_BEGIN(string_test)
       eostr += "abcdef";
       char* iter{eostr.begin()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), iter), 0 )
    }
 
@@ -454,7 +475,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr{"abcdef"};
       const char* iter{eostr.cbegin()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), iter), 0 )
    }
 
@@ -463,7 +484,7 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr{"abcdef"};
       char* iter{eostr.end()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str()+eostr.size(), iter), 0 )
    }
 
@@ -472,7 +493,7 @@ EOSIO_TEST_BEGIN(string_test)
       eostr += "abcdef";
       char* iter{eostr.end()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str()+eostr.size(), iter), 0 )
    }
 
@@ -481,7 +502,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string eostr{"abcdef"};
       const char* iter{eostr.cend()};
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.data()+eostr.size(), iter), 0 )
    }
 
@@ -512,11 +533,11 @@ EOSIO_TEST_BEGIN(string_test)
    //// size_t string::capacity() const
    {
       static string eostr{"abc"};
-      CHECK_EQUAL( eostr.capacity(), 3 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr += 'd', eostr += 'e', eostr += 'f';
-      CHECK_EQUAL( eostr.capacity(), 8 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr += 'g';
-      CHECK_EQUAL( eostr.capacity(), 8 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
    }
 
    //// size_t string::max_size() const
@@ -528,9 +549,9 @@ EOSIO_TEST_BEGIN(string_test)
    //// void reserve(const size_t n)
    {
       static string eostr{"abcdef"};
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr.reserve(10);
-      CHECK_EQUAL( eostr.capacity(), 10 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr.reserve(24);
       CHECK_EQUAL( eostr.capacity(), 24 )
       eostr.reserve(1);
@@ -540,9 +561,9 @@ EOSIO_TEST_BEGIN(string_test)
    {
       static string eostr{""};
       eostr += "abcdef";
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr.reserve(10);
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       eostr.reserve(24);
       CHECK_EQUAL( eostr.capacity(), 24 )
       eostr.reserve(1);
@@ -555,23 +576,23 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr1{"a"};
       static string eostr2{"abcdef"};
 
-      CHECK_EQUAL( eostr0.capacity(), 0 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       eostr0.reserve(100);
       CHECK_EQUAL( eostr0.capacity(), 100 )
       eostr0.shrink_to_fit();
-      CHECK_EQUAL( eostr0.capacity(), 0 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
 
-      CHECK_EQUAL( eostr1.capacity(), 1 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       eostr1.reserve(100);
       CHECK_EQUAL( eostr1.capacity(), 100 )
       eostr1.shrink_to_fit();
-      CHECK_EQUAL( eostr1.capacity(), 1 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
 
-      CHECK_EQUAL( eostr2.capacity(), 6 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       eostr2.reserve(100);
       CHECK_EQUAL( eostr2.capacity(), 100 )
       eostr2.shrink_to_fit();
-      CHECK_EQUAL( eostr2.capacity(), 6 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
    }
 
    //// void string::clear()
@@ -600,17 +621,17 @@ EOSIO_TEST_BEGIN(string_test)
 
       eostr.resize(3);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
 
       eostr.resize(5);
       CHECK_EQUAL( eostr.size(), 5 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
 
       eostr.resize(13);
       CHECK_EQUAL( eostr.size(), 13 )
-      CHECK_EQUAL( eostr.capacity(), 26 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
    }
 
@@ -620,17 +641,17 @@ EOSIO_TEST_BEGIN(string_test)
 
       eostr.resize(3);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
 
       eostr.resize(5);
       CHECK_EQUAL( eostr.size(), 5 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
 
       eostr.resize(13);
       CHECK_EQUAL( eostr.size(), 13 )
-      CHECK_EQUAL( eostr.capacity(), 26 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
    }
 
@@ -642,11 +663,11 @@ EOSIO_TEST_BEGIN(string_test)
       eostr_swap0.swap(eostr_swap1);
 
       CHECK_EQUAL( eostr_swap0.size(), 6 )
-      CHECK_EQUAL( eostr_swap0.capacity(), 6 )
+      CHECK_EQUAL( eostr_swap0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr_swap0.c_str(), "123456"), 0 )
 
       CHECK_EQUAL( eostr_swap1.size(), 3 )
-      CHECK_EQUAL( eostr_swap1.capacity(), 3 )
+      CHECK_EQUAL( eostr_swap1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr_swap1.c_str(), "abc"), 0 )
    }
 
@@ -656,7 +677,7 @@ EOSIO_TEST_BEGIN(string_test)
       CHECK_EQUAL( eostr.size(), 6 )
       eostr.push_back('g');
       CHECK_EQUAL( eostr.size(), 7 )
-      CHECK_EQUAL( eostr.capacity(), 14 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdefg"), 0 )
    }
 
@@ -871,7 +892,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"ooo"};
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "ooo"), 0 )
    }
 
@@ -880,7 +901,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"d"};
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 4 )
-      CHECK_EQUAL( eostr.capacity(), 8 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "dabc"), 0 )
    }
 
@@ -889,7 +910,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"def"};
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "defabc"), 0 )
    }
 
@@ -898,7 +919,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"ooo"};
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "oooiii") , 0 )
    }
 
@@ -907,7 +928,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"ooo"};
       eostr.insert(1, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "ioooii") , 0 )
    }
 
@@ -916,7 +937,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"ooo"};
       eostr.insert(2, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iioooi") , 0 )
    }
 
@@ -925,7 +946,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"ooo"};
       eostr.insert(3, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iiiooo") , 0 )
    }
 
@@ -941,7 +962,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "ooo";
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "ooo"), 0 )
    }
 
@@ -952,7 +973,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "d";
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 4 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "dabc"), 0 )
    }
 
@@ -963,7 +984,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "def";
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "defabc"), 0 )
    }
 
@@ -974,7 +995,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "ooo";
       eostr.insert(0, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "oooiii") , 0 )
    }
 
@@ -985,7 +1006,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "ooo";
       eostr.insert(1, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "ioooii") , 0 )
    }
 
@@ -996,7 +1017,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "ooo";
       eostr.insert(2, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iioooi") , 0 )
    }
 
@@ -1007,7 +1028,7 @@ EOSIO_TEST_BEGIN(string_test)
       str += "ooo";
       eostr.insert(3, str);
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iiiooo") , 0 )
    }
 
@@ -1021,12 +1042,12 @@ EOSIO_TEST_BEGIN(string_test)
       static string eostr = "hello";
       eostr.insert(0, "0", 1); /// `_capacity` is now 12; `_begin` now holds `std::unique_ptr<char[]>`
       CHECK_EQUAL( eostr.size(), 6 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "0hello") , 0 )
 
       eostr.insert(0, "h", 1);
       CHECK_EQUAL( eostr.size(), 7 )
-      CHECK_EQUAL( eostr.capacity(), 12 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "h0hello") , 0 )
    }
 
@@ -1239,7 +1260,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const char* str{"iii"};
       eostr.append(str);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iii"), 0 )
    }
 
@@ -1248,7 +1269,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const char* str{"iii"};
       eostr.append(str);
       CHECK_EQUAL( eostr.size(), 10 )
-      CHECK_EQUAL( eostr.capacity(), 20 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdefgiii"), 0 )
    }
 
@@ -1264,7 +1285,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"iii"};
       eostr.append(str);
       CHECK_EQUAL( eostr.size(), 3 )
-      CHECK_EQUAL( eostr.capacity(), 6 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "iii"), 0 )
    }
 
@@ -1273,7 +1294,7 @@ EOSIO_TEST_BEGIN(string_test)
       static const string str{"iii"};
       eostr.append(str);
       CHECK_EQUAL( eostr.size(), 10 )
-      CHECK_EQUAL( eostr.capacity(), 20 )
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr.c_str(), "abcdefgiii"), 0 )
    }
 
@@ -1285,18 +1306,18 @@ EOSIO_TEST_BEGIN(string_test)
 
       eostr0 += 'c';
       CHECK_EQUAL( eostr0.size(), 1 )
-      CHECK_EQUAL( eostr0.capacity(), 2 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), "c"), 0 )
 
       eostr1 += 'c';
       eostr1 += 'c';
       CHECK_EQUAL( eostr1.size(), 3 )
-      CHECK_EQUAL( eostr1.capacity(), 4 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "acc"), 0 )
 
       eostr2 += 'c';
       CHECK_EQUAL( eostr2.size(), 7 )
-      CHECK_EQUAL( eostr2.capacity(), 14 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "abcdefc"), 0 )
    }
 
@@ -1309,23 +1330,23 @@ EOSIO_TEST_BEGIN(string_test)
 
       eostr0 += "c";
       CHECK_EQUAL( eostr0.size(), 1 )
-      CHECK_EQUAL( eostr0.capacity(), 2 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), "c"), 0 )
 
       eostr1 += "c";
       eostr1 += "c";
       CHECK_EQUAL( eostr1.size(), 3 )
-      CHECK_EQUAL( eostr1.capacity(), 4 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "acc"), 0 )
 
       eostr2 += "c";
       CHECK_EQUAL( eostr2.size(), 7 )
-      CHECK_EQUAL( eostr2.capacity(), 14 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "abcdefc"), 0 )
 
       eostr3 += "ghijklm";
       CHECK_EQUAL( eostr3.size(), 13 )
-      CHECK_EQUAL( eostr3.capacity(), 26 )
+      CHECK_EQUAL( eostr3.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr3.c_str(), "abcdefghijklm"), 0 )
    }
 
@@ -1338,23 +1359,23 @@ EOSIO_TEST_BEGIN(string_test)
 
       eostr0 += string{"c"};
       CHECK_EQUAL( eostr0.size(), 1 )
-      CHECK_EQUAL( eostr0.capacity(), 2 )
+      CHECK_EQUAL( eostr0.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr0.c_str(), "c"), 0 )
 
       eostr1 += string{"c"};
       eostr1 += string{"c"};
       CHECK_EQUAL( eostr1.size(), 3 )
-      CHECK_EQUAL( eostr1.capacity(), 4 )
+      CHECK_EQUAL( eostr1.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr1.c_str(), "acc"), 0 )
 
       eostr2 += string{"c"};
       CHECK_EQUAL( eostr2.size(), 7 )
-      CHECK_EQUAL( eostr2.capacity(), 14 )
+      CHECK_EQUAL( eostr2.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr2.c_str(), "abcdefc"), 0 )
 
       eostr3 += string{"ghijklm"};
       CHECK_EQUAL( eostr3.size(), 13 )
-      CHECK_EQUAL( eostr3.capacity(), 26 )
+      CHECK_EQUAL( eostr3.capacity(), string::sso_capacity )
       CHECK_EQUAL( strcmp(eostr3.c_str(), "abcdefghijklm"), 0 )
    }
 
@@ -1494,6 +1515,116 @@ EOSIO_TEST_BEGIN(string_test)
    }
 EOSIO_TEST_END
 
+// Strings which don't fit in the inline buffer
+EOSIO_TEST_BEGIN(string_heap_test)
+   //// literals longer than `sso_capacity` are referenced until modified
+   {
+      static const char literal[] = "abcdefghijklmnopqrstuvwxyz";
+      static string eostr{literal};
+      CHECK_EQUAL( eostr.cbegin() == literal, true )
+      CHECK_EQUAL( eostr.capacity(), 26 )
+
+      eostr += '0';
+      CHECK_EQUAL( eostr.cbegin() == literal, false )
+      CHECK_EQUAL( eostr.size(), 27 )
+      CHECK_EQUAL( eostr.capacity(), 52 )
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abcdefghijklmnopqrstuvwxyz0"), 0 )
+      CHECK_EQUAL( strcmp(literal, "abcdefghijklmnopqrstuvwxyz"), 0 )
+   }
+
+   //// the capacity doubles as the string grows
+   {
+      static string eostr{};
+      size_t allocs = allocations;
+      for (size_t i = 0; i < 1000; ++i)
+         eostr += char('a' + i % 26);
+      CHECK_EQUAL( eostr.size(), 1000 )
+      CHECK_EQUAL( eostr.capacity(), 1472 )
+      CHECK_EQUAL( allocations - allocs, 6 )
+      CHECK_EQUAL( eostr[999], 'l' )
+      CHECK_EQUAL( eostr.c_str()[1000], '\0' )
+
+      eostr.resize(30);
+      eostr.shrink_to_fit();
+      CHECK_EQUAL( eostr.capacity(), 30 )
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abcdefghijklmnopqrstuvwxyzabcd"), 0 )
+
+      eostr.resize(3);
+      eostr.shrink_to_fit();
+      CHECK_EQUAL( eostr.capacity(), string::sso_capacity )
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abc"), 0 )
+   }
+
+   //// moving a heap string steals its buffer
+   {
+      static string eostr{"abcdefghijklmnopqrstuvwxyz"};
+      eostr += "0123456789";
+      const char* data = eostr.data();
+      static string eostr_mv{move(eostr)};
+      CHECK_EQUAL( eostr_mv.data() == data, true )
+      CHECK_EQUAL( eostr.size(), 0 )
+      CHECK_EQUAL( strcmp(eostr_mv.c_str(), "abcdefghijklmnopqrstuvwxyz0123456789"), 0 )
+   }
+
+   //// erasing and inserting in the middle, including a part of the string itself
+   {
+      static string eostr{"abcdefghijklmnopqrstuvwxyz"};
+      eostr.erase(3, 20);
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abcxyz"), 0 )
+      eostr.insert(3, eostr);
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abcabcxyzxyz"), 0 )
+      eostr.insert(0, eostr.data()+3, 6);
+      CHECK_EQUAL( strcmp(eostr.c_str(), "abcxyzabcabcxyzxyz"), 0 )
+   }
+
+   //// datastream >> reads straight into the string
+   {
+      static constexpr uint16_t buffer_size{256};
+      static char datastream_buffer[buffer_size]{};
+      static datastream<char*> ds{datastream_buffer, buffer_size};
+
+      static const string cstr {"a memo longer than the inline buffer of eosio::string"};
+      static string str{"previous contents"};
+      ds << cstr;
+      ds.seekp(0);
+      size_t allocs = allocations;
+      ds >> str;
+      CHECK_EQUAL( allocations - allocs, 1 )
+      CHECK_EQUAL( cstr, str )
+      CHECK_EQUAL( str.capacity(), cstr.size() )
+   }
+EOSIO_TEST_END
+
+// Compares building strings a character at a time with std::string, run with -v to see the results
+EOSIO_TEST_BEGIN(string_bench)
+   static const char memo[] = "transfer of 1.0000 EOS from alice to bob for services rendered";
+
+   for (size_t len : {16, 64}) {
+      size_t allocs = allocations;
+      EOSIO_BENCH( "eosio::string", 1000,
+         string s;
+         for (size_t i = 0; i < len; ++i)
+            s += memo[i];
+         bench_do_not_optimize(s);
+      )
+      eosio::print("   ", len, " characters, ", (allocations - allocs) / 1000, " allocations\n");
+
+      allocs = allocations;
+      EOSIO_BENCH( "std::string", 1000,
+         std::string s;
+         for (size_t i = 0; i < len; ++i)
+            s += memo[i];
+         bench_do_not_optimize(s);
+      )
+      eosio::print("   ", len, " characters, ", (allocations - allocs) / 1000, " allocations\n");
+   }
+
+   string s;
+   for (size_t i = 0; i < 16; ++i)
+      s += memo[i];
+   CHECK_EQUAL( strcmp(s.c_str(), "transfer of 1.00"), 0 )
+EOSIO_TEST_END
+
 int main(int argc, char* argv[]) {
    bool verbose = false;
    if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
@@ -1502,5 +1633,7 @@ int main(int argc, char* argv[]) {
    silence_output(!verbose);
 
    EOSIO_TEST(string_test)
+   EOSIO_TEST(string_heap_test)
+   EOSIO_TEST(string_bench)
    return has_failed();
 }
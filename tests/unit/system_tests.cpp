@@ -5,6 +5,7 @@
 
 #include <string>
 
+#include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/tester.hpp>
 
@@ -12,6 +13,16 @@ using std::move;
 using std::string;
 
 using eosio::check;
+using eosio::check_f;
+
+// counts how often a check() message argument is converted to a string
+struct counted {
+   static inline int conversions = 0;
+   std::string to_string()const {
+      ++conversions;
+      return "counted";
+   }
+};
 
 // Definitions in `eosio.cdt/libraries/eosiolib/system.hpp`
 EOSIO_TEST_BEGIN(system_test)
@@ -30,6 +41,7 @@ EOSIO_TEST_BEGIN(system_test)
    // --------------------------------------------
    // inline void check(bool, const char*, size_t)
    CHECK_ASSERT( "assert", []() { const char* str{"asserted"}; check(false, str, 6);} );
+   CHECK_ASSERT( "too m", []() { check(false, "too many items: %", 5);} );
 
    // ----------------------------------------------
    // inline void check(bool, const string&, size_t)
@@ -41,6 +53,44 @@ EOSIO_TEST_BEGIN(system_test)
    CHECK_ASSERT("100", []() { check(false, 100);} );
    CHECK_ASSERT("18446744073709551615", []() { check(false, 18446744073709551615ULL);} );
    CHECK_ASSERT("18446744073709551615", []() { check(false, -1ULL);} );
+
+   // ---------------------------------------------------------------
+   // inline void check_f(bool, const char*, const Args&...)
+   CHECK_ASSERT( "balance -5 is below 0", []() { check_f(false, "balance % is below %", -5, 0);} );
+   CHECK_ASSERT( "alice can't transfer 1.0000 EOS", []() {
+      check_f(false, "% can't transfer %", eosio::name{"alice"}, eosio::asset{10000, eosio::symbol{"EOS", 4}});
+   } );
+   CHECK_ASSERT( "memo: hi, flag: true, char: c", []() {
+      const string memo{"hi"};
+      check_f(false, "memo: %, flag: %, char: %", memo, true, 'c');
+   } );
+   CHECK_ASSERT( "18446744073709551615 and -9223372036854775808", []() {
+      check_f(false, "% and %", UINT64_MAX, INT64_MIN);
+   } );
+   CHECK_ASSERT( "counted", []() { check_f(false, "%", counted{});} );
+   CHECK_ASSERT( "extra arguments are ignored", []() { check_f(false, "extra arguments are ignored", "a", 1);} );
+   CHECK_ASSERT( "1 of %", []() { check_f(false, "% of %", "1");} );
+
+   CHECK_ASSERT( "no arguments", []() { check_f(false, "no arguments");} );
+
+   // a single integer is formatted wherever its `%` is, it is not a message length
+   CHECK_ASSERT( "count is 0", []() { check_f(false, "count is %", 0);} );
+   CHECK_ASSERT( "too many items: 5", []() { check_f(false, "too many items: %", 5);} );
+   CHECK_ASSERT( "ab: 2", []() { check_f(false, "ab: %", 2u);} );
+
+   // messages longer than EOSIO_CHECK_MESSAGE_SIZE are truncated
+   CHECK_ASSERT( [](const string&) {
+      return std_err.index == EOSIO_CHECK_MESSAGE_SIZE &&
+             string(std_err.get(), std_err.index) == string(EOSIO_CHECK_MESSAGE_SIZE, 'x');
+   }, []() {
+      const string long_message(EOSIO_CHECK_MESSAGE_SIZE * 2, 'x');
+      check_f(false, "%%", long_message, long_message);
+   } );
+
+   // arguments are only formatted when the check fails
+   counted::conversions = 0;
+   check_f(true, "% % %", counted{}, counted{}, counted{});
+   CHECK_EQUAL( counted::conversions, 0 )
 EOSIO_TEST_END
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,217 @@
+/**
+ *  @file
+ *  @copyright defined in eosio.cdt/LICENSE.txt
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/transaction.hpp>
+#include <eosio/tester.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace eosio::native;
+using eosio::action;
+using eosio::action_view;
+using eosio::name;
+using eosio::permission_level;
+using eosio::transaction;
+using eosio::transaction_builder;
+
+// the last deferred transaction the contract sent
+static std::vector<char> sent_trx;
+static uint64_t sent_payer = 0;
+static uint32_t sent_replace = 0;
+
+// actions and context free data of the active transaction, and calls made to read them
+static std::vector<std::vector<char>> trx_actions, trx_context_free_data;
+static size_t read_calls = 0;
+
+static void install_transaction_intrinsics() {
+   // the chain returns the size of the action and copies it only when it fits
+   intrinsics::set_intrinsic<intrinsics::get_action>([](uint32_t, uint32_t index, char* buff, size_t size) -> int {
+      ++read_calls;
+      if (index >= trx_actions.size())
+         return -1;
+      const auto& act = trx_actions[index];
+      if (act.size() <= size)
+         memcpy(buff, act.data(), act.size());
+      return act.size();
+   });
+   // while context free data is copied up to the buffer size, and its size is returned for an empty buffer
+   intrinsics::set_intrinsic<intrinsics::get_context_free_data>([](uint32_t index, char* buff, size_t size) -> int {
+      ++read_calls;
+      if (index >= trx_context_free_data.size())
+         return -1;
+      const auto& data = trx_context_free_data[index];
+      if (size == 0)
+         return data.size();
+      size_t copied = std::min(size, data.size());
+      memcpy(buff, data.data(), copied);
+      return copied;
+   });
+}
+
+struct transfer {
+   name        from;
+   name        to;
+   uint64_t    amount;
+   std::string memo;
+
+   EOSLIB_SERIALIZE( transfer, (from)(to)(amount)(memo) )
+};
+
+static transaction make_transaction() {
+   transaction trx(eosio::time_point_sec(1000));
+   trx.ref_block_num = 7;
+   trx.ref_block_prefix = 12345;
+   trx.delay_sec = 10;
+   return trx;
+}
+
+EOSIO_TEST_BEGIN(transaction_builder_test)
+   intrinsics::set_intrinsic<intrinsics::send_deferred>([](const uint128_t&, uint64_t payer, const char* data, size_t size, uint32_t replace) {
+      sent_trx.assign(data, data + size);
+      sent_payer = payer;
+      sent_replace = replace;
+   });
+   // unpacking a transaction constructs its default expiration
+   intrinsics::set_intrinsic<intrinsics::current_time>([]() -> uint64_t { return 0; });
+   const permission_level active{"alice"_n, "active"_n};
+   const std::vector<permission_level> auths = {active, {"bob"_n, "owner"_n}};
+
+   // the packed transaction is the same as the one of a transaction holding the same actions
+   transaction trx = make_transaction();
+   trx.context_free_actions.emplace_back(std::vector<permission_level>{}, "eosio.null"_n, "nonce"_n, std::string("abc"));
+   for (uint64_t i = 0; i < 3; i++)
+      trx.actions.emplace_back(active, "eosio.token"_n, "transfer"_n, transfer{"alice"_n, "bob"_n, i, "payout"});
+   trx.actions.emplace_back(auths, "eosio.token"_n, "open"_n, std::make_tuple("bob"_n, (uint64_t)4));
+   trx.actions.emplace_back(active, "eosio.token"_n, "noop"_n, std::make_tuple());
+   trx.send(1, "alice"_n);
+   const auto expected = sent_trx;
+
+   transaction_builder builder(make_transaction());
+   builder.add_context_free_action("eosio.null"_n, "nonce"_n, std::string("abc"));
+   for (uint64_t i = 0; i < 3; i++)
+      builder.add_action(active, "eosio.token"_n, "transfer"_n, "alice"_n, "bob"_n, i, std::string("payout"));
+   builder.add_action(auths, "eosio.token"_n, "open"_n, "bob"_n, (uint64_t)4);
+   builder.add_action(active, "eosio.token"_n, "noop"_n);
+   builder.send(1, "carol"_n, true);
+   CHECK_EQUAL( sent_trx == expected, true )
+   CHECK_EQUAL( sent_payer, "carol"_n.value )
+   CHECK_EQUAL( sent_replace, 1 )
+
+   // the transaction is unpacked as it was built
+   auto unpacked = eosio::unpack<transaction>(sent_trx);
+   CHECK_EQUAL( unpacked.expiration == eosio::time_point_sec(1000), true )
+   CHECK_EQUAL( unpacked.delay_sec.value, 10 )
+   CHECK_EQUAL( unpacked.context_free_actions.size(), 1 )
+   CHECK_EQUAL( unpacked.actions.size(), 5 )
+   CHECK_EQUAL( unpacked.actions[2].data_as<transfer>().amount, 2 )
+   CHECK_EQUAL( unpacked.actions[3].authorization.size(), 2 )
+
+   // sending again sends the same transaction
+   builder.send(2, "carol"_n);
+   CHECK_EQUAL( sent_trx == expected, true )
+   CHECK_ASSERT( "cannot add actions to a transaction_builder which was sent", [&]() {
+      builder.add_action(active, "eosio.token"_n, "noop"_n);
+   })
+
+   // counts which take several bytes, and transactions without any action
+   transaction large = make_transaction();
+   transaction_builder large_builder(make_transaction());
+   for (uint64_t i = 0; i < 200; i++) {
+      large.context_free_actions.emplace_back(std::vector<permission_level>{}, "eosio.null"_n, "nonce"_n, i);
+      large_builder.add_context_free_action("eosio.null"_n, "nonce"_n, i);
+   }
+   large.send(1, "alice"_n);
+   const auto large_expected = sent_trx;
+   large_builder.send(1, "alice"_n);
+   CHECK_EQUAL( sent_trx == large_expected, true )
+
+   make_transaction().send(1, "alice"_n);
+   const auto empty_expected = sent_trx;
+   transaction_builder(make_transaction()).send(1, "alice"_n);
+   CHECK_EQUAL( sent_trx == empty_expected, true )
+
+   CHECK_ASSERT( "context free actions must be added before actions", [&]() {
+      transaction_builder b(make_transaction());
+      b.add_action(active, "eosio.token"_n, "noop"_n);
+      b.add_context_free_action("eosio.null"_n, "nonce"_n);
+   })
+EOSIO_TEST_END
+
+EOSIO_TEST_BEGIN(action_view_test)
+   install_transaction_intrinsics();
+   const permission_level active{"alice"_n, "active"_n};
+   trx_actions.clear();
+   for (uint64_t i = 0; i < 20; i++)
+      trx_actions.push_back(eosio::pack(action(active, "eosio.token"_n, "transfer"_n, transfer{"alice"_n, "bob"_n, i, "fee"})));
+   trx_actions.push_back(eosio::pack(action(std::vector<permission_level>{active, {"bob"_n, "owner"_n}}, "eosio"_n, "setcode"_n, std::vector<char>(2000, 'x'))));
+
+   // the fields are read from the packed action
+   action_view view = eosio::get_action_view(1, 3);
+   CHECK_EQUAL( view.account(), "eosio.token"_n )
+   CHECK_EQUAL( view.name(), "transfer"_n )
+   CHECK_EQUAL( view.authorization_size(), 1 )
+   CHECK_EQUAL( view.authorization(0) == active, true )
+   CHECK_EQUAL( view.data_as<transfer>().amount, 3 )
+   CHECK_EQUAL( view.data_size(), eosio::pack_size(transfer{"alice"_n, "bob"_n, 3, "fee"}) )
+   CHECK_EQUAL( eosio::pack(view.to_action()) == trx_actions[3], true )
+   CHECK_ASSERT( "action_view: authorization index out of range", [&]() { view.authorization(1); })
+
+   // each action is read with one call into the same buffer
+   read_calls = 0;
+   const char* buffer = eosio::get_action_view(1, 0).data();
+   for (uint32_t i = 0; i < 20; i++) {
+      action_view v = eosio::get_action_view(1, i);
+      CHECK_EQUAL( v.data() == buffer, true )
+      CHECK_EQUAL( v.account(), "eosio.token"_n )
+   }
+   CHECK_EQUAL( read_calls, 21 )
+
+   // actions larger than the buffer grow it
+   read_calls = 0;
+   action_view large = eosio::get_action_view(1, 20);
+   CHECK_EQUAL( read_calls, 2 )
+   CHECK_EQUAL( large.name(), "setcode"_n )
+   CHECK_EQUAL( large.authorization_size(), 2 )
+   CHECK_EQUAL( large.authorization(1) == permission_level("bob"_n, "owner"_n), true )
+   CHECK_EQUAL( large.data_as<std::vector<char>>().size(), 2000 )
+   read_calls = 0;
+   eosio::get_action_view(1, 20);
+   CHECK_EQUAL( read_calls, 1 )
+
+   auto act = eosio::get_action(1, 5);
+   CHECK_EQUAL( act.name, "transfer"_n )
+   CHECK_EQUAL( act.data_as<transfer>().amount, 5 )
+   CHECK_ASSERT( "get_action size failed", []() { eosio::get_action_view(1, 21); })
+   CHECK_ASSERT( "action_view: data is truncated", [&]() {
+      action_view(trx_actions[0].data(), trx_actions[0].size() - 1).data();
+   })
+
+   // context free data
+   trx_context_free_data = {eosio::pack(std::string("nonce")), std::vector<char>(5000, 'y'), {}};
+   CHECK_EQUAL( eosio::get_context_free_data_view(0).remaining(), trx_context_free_data[0].size() )
+   std::string nonce;
+   auto ds = eosio::get_context_free_data_view(0);
+   ds >> nonce;
+   CHECK_EQUAL( nonce, "nonce" )
+   auto big = eosio::get_context_free_data_view(1);
+   CHECK_EQUAL( big.remaining(), 5000 )
+   CHECK_EQUAL( std::string(big.pos(), 5000) == std::string(5000, 'y'), true )
+   CHECK_EQUAL( eosio::get_context_free_data_view(2).remaining(), 0 )
+   CHECK_ASSERT( "get_context_free_data failed", []() { eosio::get_context_free_data_view(3); })
+EOSIO_TEST_END
+
+int main(int argc, char** argv) {
+   bool verbose = false;
+   if( argc >= 2 && std::strcmp( argv[1], "-v" ) == 0 ) {
+      verbose = true;
+   }
+   silence_output(!verbose);
+
+   EOSIO_TEST(transaction_builder_test);
+   EOSIO_TEST(action_view_test);
+   return has_failed();
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2017 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/size-report.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <fstream>
+#include <map>
+
+#include "src/binary-reader-nop.h"
+#include "src/binary.h"
+#include "src/stream.h"
+
+namespace wabt {
+
+namespace {
+
+class NamesReader : public BinaryReaderNop {
+ public:
+  explicit NamesReader(std::map<Index, std::string>* names) : names_(names) {}
+
+  Result OnFunctionName(Index index, string_view name) override {
+    (*names_)[index] = name.to_string();
+    return Result::Ok;
+  }
+
+ private:
+  std::map<Index, std::string>* names_;
+};
+
+struct FuncSize {
+  Index index;
+  Offset size;
+  std::string name;
+  std::string library;
+};
+
+class SizeReader : public BinaryReaderNop {
+ public:
+  Result BeginSection(BinarySection section_type, Offset size) override {
+    section_sizes[section_type] += size;
+    return Result::Ok;
+  }
+
+  Result OnImportFunc(Index import_index,
+                      string_view module_name,
+                      string_view field_name,
+                      Index func_index,
+                      Index sig_index) override {
+    num_func_imports++;
+    return Result::Ok;
+  }
+
+  Result BeginFunctionBody(Index index) override {
+    body_start_ = state->offset;
+    return Result::Ok;
+  }
+
+  Result EndFunctionBody(Index index) override {
+    funcs.push_back(FuncSize{index, state->offset - body_start_, "", ""});
+    return Result::Ok;
+  }
+
+  Result OnOpcode(Opcode opcode) override {
+    opcodes[opcode.GetName()]++;
+    return Result::Ok;
+  }
+
+  Result OnDataSegmentData(Index index,
+                           const void* data,
+                           Address size) override {
+    data_bytes += size;
+    data_segments++;
+    return Result::Ok;
+  }
+
+  std::map<BinarySection, Offset> section_sizes;
+  std::vector<FuncSize> funcs;
+  std::map<std::string, uint64_t> opcodes;
+  Index num_func_imports = 0;
+  Offset data_bytes = 0;
+  Index data_segments = 0;
+
+ private:
+  Offset body_start_ = 0;
+};
+
+// groups the archives of the CDT into the libraries they are built from
+std::string LibraryOfFile(const std::string& path) {
+  std::string file = path.substr(path.find_last_of('/') + 1);
+  if (file.compare(0, 5, "libc+") == 0)
+    return "libc++";
+  if (file == "libc.a")
+    return "musl";
+  if (file.compare(0, 8, "libeosio") == 0)
+    return "eosiolib";
+  if (file == "librt.a" || file == "libsf.a")
+    return "compiler-rt";
+  if (file.size() > 2 && file.compare(file.size() - 2, 2, ".a") == 0)
+    return file;
+  return "contract";
+}
+
+// used for symbols missing from the symbols file
+std::string LibraryOfName(const std::string& name) {
+  if (name.compare(0, 8, "_ZNSt3__") == 0 || name.compare(0, 7, "std::__") == 0)
+    return "libc++";
+  if (name.compare(0, 9, "_ZN5eosio") == 0 || name.compare(0, 7, "eosio::") == 0)
+    return "eosiolib";
+  if (name.compare(0, 2, "__") == 0)
+    return "compiler-rt";
+  return "unknown";
+}
+
+// parses the output of `nm --defined-only --demangle -A`, e.g.
+//   /usr/local/eosio.cdt/lib/libc.a:memcpy.o: 00000001 T memcpy
+//   hello.o: 00000005 T apply
+//   hello.o: 00000009 T hello::hi(eosio::name)
+// the names are demangled like those of the name section. The first definition
+// of a name is kept and the objects of the contract are listed before the
+// libraries, so templates of libc++ and eosiolib instantiated in the contract
+// are attributed to the contract
+void ReadSymbols(const std::string& filename,
+                 std::map<std::string, std::string>* libraries) {
+  std::ifstream in(filename);
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t sep = line.find(": ");
+    if (sep == std::string::npos)
+      continue;
+    std::string file = line.substr(0, line.find(':'));
+    // skip the address and the symbol type
+    size_t name = line.find(' ', sep + 2);
+    if (name == std::string::npos || name + 3 > line.size())
+      continue;
+    libraries->emplace(line.substr(name + 3), LibraryOfFile(file));
+  }
+}
+
+std::string Percent(uint64_t part, uint64_t total) {
+  return StringPrintf("%5.1f%%", total ? 100.0 * part / total : 0.0);
+}
+
+}  // end anonymous namespace
+
+Result WriteSizeReport(Stream* out,
+                       const std::vector<uint8_t>& names_wasm,
+                       const std::vector<uint8_t>& wasm,
+                       const SizeReportOptions& options) {
+  Features features;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+
+  std::map<Index, std::string> names;
+  NamesReader names_reader(&names);
+  ReadBinaryOptions names_options(features, nullptr, true, kStopOnFirstError,
+                                  kFailOnCustomSectionError);
+  CHECK_RESULT(ReadBinary(names_wasm.data(), names_wasm.size(), &names_reader,
+                          &names_options));
+
+  SizeReader reader;
+  ReadBinaryOptions read_options(features, nullptr, false, kStopOnFirstError,
+                                 kFailOnCustomSectionError);
+  CHECK_RESULT(ReadBinary(wasm.data(), wasm.size(), &reader, &read_options));
+
+  std::map<std::string, std::string> libraries;
+  if (!options.symbols_file.empty())
+    ReadSymbols(options.symbols_file, &libraries);
+
+  out->Writef("Size report (%" PRIzd " bytes)\n\n", wasm.size());
+  out->Writef("Sections:\n");
+  for (const auto& section : reader.section_sizes)
+    out->Writef("  %10" PRIzd " %s  %s\n", section.second,
+                Percent(section.second, wasm.size()).c_str(),
+                GetSectionName(section.first));
+
+  Offset code_bytes = 0;
+  std::map<std::string, std::pair<Offset, Index>> by_library;
+  for (FuncSize& func : reader.funcs) {
+    auto name = names.find(func.index);
+    func.name = name != names.end()
+                    ? name->second
+                    : "func[" + std::to_string(func.index) + "]";
+    auto library = libraries.find(func.name);
+    func.library = library != libraries.end() ? library->second
+                                              : LibraryOfName(func.name);
+    by_library[func.library].first += func.size;
+    by_library[func.library].second++;
+    code_bytes += func.size;
+  }
+
+  std::vector<std::pair<std::string, std::pair<Offset, Index>>> sorted_libraries(
+      by_library.begin(), by_library.end());
+  std::sort(sorted_libraries.begin(), sorted_libraries.end(),
+            [](const std::pair<std::string, std::pair<Offset, Index>>& a,
+               const std::pair<std::string, std::pair<Offset, Index>>& b) {
+              return a.second.first > b.second.first;
+            });
+  out->Writef("\nCode by library (%" PRIzd " bytes in %" PRIzd " functions):\n",
+              code_bytes, reader.funcs.size());
+  out->Writef("  (library templates instantiated in the contract count as contract)\n");
+  for (const auto& library : sorted_libraries)
+    out->Writef("  %10" PRIzd " %s %6u functions  %s\n", library.second.first,
+                Percent(library.second.first, code_bytes).c_str(),
+                library.second.second, library.first.c_str());
+
+  out->Writef("\nData: %" PRIzd " bytes in %u segments\n", reader.data_bytes,
+              reader.data_segments);
+
+  std::sort(reader.funcs.begin(), reader.funcs.end(),
+            [](const FuncSize& a, const FuncSize& b) { return a.size > b.size; });
+  out->Writef("\nLargest functions:\n");
+  for (size_t i = 0; i < reader.funcs.size() && i < static_cast<size_t>(options.top); ++i)
+    out->Writef("  %10" PRIzd " %s  %-12s %s\n", reader.funcs[i].size,
+                Percent(reader.funcs[i].size, code_bytes).c_str(),
+                reader.funcs[i].library.c_str(), reader.funcs[i].name.c_str());
+
+  std::vector<std::pair<std::string, uint64_t>> opcodes(reader.opcodes.begin(),
+                                                        reader.opcodes.end());
+  uint64_t total_opcodes = 0;
+  for (const auto& opcode : opcodes)
+    total_opcodes += opcode.second;
+  std::sort(opcodes.begin(), opcodes.end(),
+            [](const std::pair<std::string, uint64_t>& a,
+               const std::pair<std::string, uint64_t>& b) {
+              return a.second > b.second;
+            });
+  out->Writef("\nOpcode histogram (%" PRIu64 " instructions):\n", total_opcodes);
+  for (size_t i = 0; i < opcodes.size() && i < static_cast<size_t>(options.top); ++i)
+    out->Writef("  %10" PRIu64 " %s  %s\n", opcodes[i].second,
+                Percent(opcodes[i].second, total_opcodes).c_str(),
+                opcodes[i].first.c_str());
+  return Result::Ok;
+}
+
+}  // namespace wabt
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2017 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WABT_SIZE_REPORT_H_
+#define WABT_SIZE_REPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "src/common.h"
+
+namespace wabt {
+
+class Stream;
+
+struct SizeReportOptions {
+  // output of `nm --defined-only --demangle -A`, used to attribute functions to the
+  // archive or object file that defined them
+  std::string symbols_file;
+  // number of functions and opcodes listed
+  int top = 20;
+};
+
+// Attributes the bytes of `wasm` to sections, functions and libraries and
+// prints an opcode histogram. Function names are taken from the name section
+// of `names_wasm`, which is the module before post-processing stripped it.
+Result WriteSizeReport(Stream*,
+                       const std::vector<uint8_t>& names_wasm,
+                       const std::vector<uint8_t>& wasm,
+                       const SizeReportOptions&);
+
+}  // namespace wabt
+
+#endif /* WABT_SIZE_REPORT_H_ */
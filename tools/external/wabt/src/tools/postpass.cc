@@ -15,10 +15,14 @@
  */
 
 #include <cassert>
+#include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sys/resource.h>
+#include <unistd.h>
 
 #include "src/apply-names.h"
 #include "src/binary-reader.h"
@@ -30,6 +34,7 @@
 #include "src/ir.h"
 #include "src/leb128.h"
 #include "src/option-parser.h"
+#include "src/size-report.h"
 #include "src/stream.h"
 #include "src/validator.h"
 #include "src/wast-lexer.h"
@@ -43,6 +48,9 @@ static std::string s_outfile;
 static Features s_features;
 static WriteBinaryOptions s_write_binary_options;
 static std::unique_ptr<FileStream> s_log_stream;
+static std::string s_time_trace;
+static bool s_size_report;
+static SizeReportOptions s_size_report_options;
 
 static const char s_description[] =
 R"(  Read a file in the WebAssembly binary format, strip bss or any data segment that is only initialized to zeros, and other post processing.
@@ -68,6 +76,29 @@ static void ParseOptions(int argc, char** argv) {
         s_outfile = argument;
         ConvertBackslashToSlash(&s_outfile);
       });
+  parser.AddOption(
+      '\0', "time-trace", "FILENAME",
+      "Append stage timings to FILENAME in Chrome trace-event format",
+      [](const char* argument) {
+        s_time_trace = argument;
+      });
+  parser.AddOption("size-report",
+                   "Print the code and data size by section, function and "
+                   "library, and an opcode histogram",
+                   []() { s_size_report = true; });
+  parser.AddOption(
+      '\0', "symbols", "FILENAME",
+      "Output of `eosio-nm --defined-only --demangle -A` for the linked "
+      "objects and libraries, used to attribute functions in the size report",
+      [](const char* argument) {
+        s_size_report_options.symbols_file = argument;
+      });
+  parser.AddOption(
+      '\0', "top", "N",
+      "Number of functions and opcodes listed in the size report",
+      [](const char* argument) {
+        s_size_report_options.top = atoi(argument);
+      });
   parser.AddArgument("filename", OptionParser::ArgumentCount::One,
                      [](const char* argument) {
                        s_infile = argument;
@@ -124,6 +155,27 @@ void AddHeapPointerData( Module& mod, size_t fixup, const std::vector<uint8_t>&
 void construct_apply( Module& mod ) {
 }
 
+uint64_t TraceNow() {
+   return std::chrono::duration_cast<std::chrono::microseconds>(
+         std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// the file was started by eosio-cpp/eosio-ld in the JSON array format, so events are only appended
+void TraceEvent( const char* name, uint64_t start, size_t size ) {
+   if (s_time_trace.empty())
+      return;
+   struct rusage ru;
+   long peak_rss = getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : 0;
+#ifdef __APPLE__
+   peak_rss /= 1024;
+#endif
+   std::ofstream out(s_time_trace, std::ios::app);
+   out << "{\"name\":\"" << name << "\",\"cat\":\"eosio-pp\",\"ph\":\"X\""
+       << ",\"ts\":" << start << ",\"dur\":" << TraceNow()-start
+       << ",\"pid\":" << getpid() << ",\"tid\":0"
+       << ",\"args\":{\"size\":" << size << ",\"peak_rss_kb\":" << peak_rss << "}},\n";
+}
+
 void WriteBufferToFile(string_view filename,
                        const OutputBuffer& buffer) {
   buffer.WriteToFile(filename);
@@ -138,6 +190,7 @@ int ProgramMain(int argc, char** argv) {
   std::vector<uint8_t> file_data;
   bool stub = false;
   std::unique_ptr<FileStream> s_log_stream_s;
+  uint64_t start = TraceNow();
   result = ReadFile(s_infile.c_str(), &file_data);
   DataSegment _hds;
   if (Succeeded(result)) {
@@ -149,12 +202,16 @@ int ProgramMain(int argc, char** argv) {
                               stub);
     result = ReadBinaryIr(s_infile.c_str(), file_data.data(),
                           file_data.size(), &options, &error_handler, &module);
+    TraceEvent("read", start, file_data.size());
 
     if (Succeeded(result)) {
       size_t fixup = 0;
+      start = TraceNow();
       StripZeroedData(module, fixup);
       AddHeapPointerData(module, fixup, file_data, _hds);
+      TraceEvent("strip zeroed data", start, fixup);
      if (Succeeded(result)) {
+      start = TraceNow();
       MemoryStream stream(s_log_stream.get());
       result =
           WriteBinaryModule(&stream, &module, &s_write_binary_options);
@@ -165,6 +222,15 @@ int ProgramMain(int argc, char** argv) {
         }
         WriteBufferToFile(s_outfile.c_str(), stream.output_buffer());
       }
+      TraceEvent("write", start, stream.output_buffer().size());
+
+      if (Succeeded(result) && s_size_report) {
+        start = TraceNow();
+        FileStream out(stdout);
+        result = WriteSizeReport(&out, file_data, stream.output_buffer().data,
+                                 s_size_report_options);
+        TraceEvent("size report", start, stream.output_buffer().size());
+      }
     }
    } 
 
@@ -0,0 +1,1295 @@
+/*
+ * Copyright 2016 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "src/binary-reader-interp.h"
+#include "src/binary-reader-ir.h"
+#include "src/binary-reader.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/interp.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+
+using namespace wabt;
+using namespace wabt::interp;
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_actions_file;
+static std::string s_receiver = "profile";
+static int s_top = 20;
+static bool s_print;
+static Features s_features;
+static std::unique_ptr<FileStream> s_log_stream;
+
+static const char s_description[] =
+R"(  Run a contract on the wabt interpreter with a list of recorded actions and
+  report where the instructions are spent: per function instruction and call
+  counts, the hottest loops and the number of calls to each intrinsic.
+
+  The actions file has one action per line, `<code> <action> <hex data>`,
+  and lines starting with '#' are ignored. Intrinsics are stubbed: the
+  action, authorization, print, assert and memory intrinsics, the i64
+  database API and the secondary indices are emulated in memory, the
+  remaining intrinsics return 0.
+
+examples:
+  $ eosio-wasm-profile hello.wasm --actions hello.actions --top 10
+)";
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-wasm-profile", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  parser.AddOption('a', "actions", "FILENAME",
+                   "File with the actions to run, one per line",
+                   [](const char* argument) { s_actions_file = argument; });
+  parser.AddOption('r', "receiver", "NAME",
+                   "Account the contract is deployed to, default `profile`",
+                   [](const char* argument) { s_receiver = argument; });
+  parser.AddOption('n', "top", "N", "Number of entries in each table",
+                   [](const char* argument) { s_top = atoi(argument); });
+  parser.AddOption('p', "print", "Forward the contract prints to stdout",
+                   []() { s_print = true; });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) { s_infile = argument; });
+  parser.Parse(argc, argv);
+
+  if (s_actions_file.empty()) {
+    fprintf(stderr, "eosio-wasm-profile requires an actions file (--actions).\n");
+    exit(1);
+  }
+}
+
+static uint64_t StringToName(const std::string& str) {
+  auto char_to_value = [](char c) -> uint64_t {
+    if (c == '.')
+      return 0;
+    else if (c >= '1' && c <= '5')
+      return (c - '1') + 1;
+    else if (c >= 'a' && c <= 'z')
+      return (c - 'a') + 6;
+    return 0;
+  };
+  uint64_t value = 0;
+  size_t i = 0;
+  for (; i < str.size() && i < 12; ++i)
+    value |= (char_to_value(str[i]) & 0x1f) << (64 - 5 * (i + 1));
+  if (i < str.size())
+    value |= char_to_value(str[i]) & 0x0f;
+  return value;
+}
+
+static std::string NameToString(uint64_t value) {
+  static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+  std::string str(13, '.');
+  uint64_t tmp = value;
+  for (int i = 0; i <= 12; ++i) {
+    char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+    str[12 - i] = c;
+    tmp >>= (i == 0 ? 4 : 5);
+  }
+  str.erase(str.find_last_not_of('.') + 1);
+  return str;
+}
+
+struct RecordedAction {
+  uint64_t code;
+  uint64_t name;
+  std::vector<char> data;
+};
+
+static wabt::Result ReadActions(const std::string& filename,
+                                std::vector<RecordedAction>* actions) {
+  std::ifstream in(filename);
+  if (!in) {
+    fprintf(stderr, "error: unable to read %s\n", filename.c_str());
+    return wabt::Result::Error;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream ss(line);
+    std::string code, name, hex;
+    if (!(ss >> code) || code[0] == '#')
+      continue;
+    if (!(ss >> name)) {
+      fprintf(stderr, "error: expected `<code> <action> <hex data>`: %s\n",
+              line.c_str());
+      return wabt::Result::Error;
+    }
+    ss >> hex;
+    RecordedAction action;
+    action.code = StringToName(code);
+    action.name = StringToName(name);
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+      action.data.push_back(
+          static_cast<char>(strtoul(hex.substr(i, 2).c_str(), nullptr, 16)));
+    actions->push_back(std::move(action));
+  }
+  return wabt::Result::Ok;
+}
+
+// the i64 database of nodeos, kept in memory for all of the actions of a run
+class Database {
+ public:
+  int32_t Store(uint64_t code, uint64_t scope, uint64_t table, uint64_t id,
+                const char* data, uint32_t len) {
+    Index t = FindOrCreateTable(code, scope, table);
+    tables_[t].rows[id].assign(data, data + len);
+    return AddIterator(t, id);
+  }
+
+  int32_t Find(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+    Index t = FindOrCreateTable(code, scope, table);
+    if (!tables_[t].rows.count(id))
+      return EndIterator(t);
+    return AddIterator(t, id);
+  }
+
+  int32_t LowerBound(uint64_t code, uint64_t scope, uint64_t table,
+                     uint64_t id) {
+    Index t = FindOrCreateTable(code, scope, table);
+    auto it = tables_[t].rows.lower_bound(id);
+    return it == tables_[t].rows.end() ? EndIterator(t) : AddIterator(t, it->first);
+  }
+
+  int32_t UpperBound(uint64_t code, uint64_t scope, uint64_t table,
+                     uint64_t id) {
+    Index t = FindOrCreateTable(code, scope, table);
+    auto it = tables_[t].rows.upper_bound(id);
+    return it == tables_[t].rows.end() ? EndIterator(t) : AddIterator(t, it->first);
+  }
+
+  int32_t End(uint64_t code, uint64_t scope, uint64_t table) {
+    return EndIterator(FindOrCreateTable(code, scope, table));
+  }
+
+  // returns nullptr for end and invalidated iterators
+  std::vector<char>* Row(int32_t itr, uint64_t* id = nullptr) {
+    if (itr < 0 || static_cast<size_t>(itr) >= iterators_.size())
+      return nullptr;
+    auto& rows = tables_[iterators_[itr].first].rows;
+    auto it = rows.find(iterators_[itr].second);
+    if (it == rows.end())
+      return nullptr;
+    if (id)
+      *id = it->first;
+    return &it->second;
+  }
+
+  void Remove(int32_t itr) {
+    uint64_t id;
+    if (Row(itr, &id))
+      tables_[iterators_[itr].first].rows.erase(id);
+  }
+
+  int32_t Next(int32_t itr, uint64_t* id) {
+    if (!Row(itr))
+      return -1;
+    Index t = iterators_[itr].first;
+    auto it = tables_[t].rows.upper_bound(iterators_[itr].second);
+    if (it == tables_[t].rows.end())
+      return EndIterator(t);
+    *id = it->first;
+    return AddIterator(t, it->first);
+  }
+
+  int32_t Previous(int32_t itr, uint64_t* id) {
+    Index t;
+    std::map<uint64_t, std::vector<char>>::iterator it;
+    if (itr < -1) {
+      t = -itr - 2;
+      if (t >= tables_.size() || tables_[t].rows.empty())
+        return -1;
+      it = tables_[t].rows.end();
+    } else if (Row(itr)) {
+      t = iterators_[itr].first;
+      it = tables_[t].rows.find(iterators_[itr].second);
+      if (it == tables_[t].rows.begin())
+        return -1;
+    } else {
+      return -1;
+    }
+    --it;
+    *id = it->first;
+    return AddIterator(t, it->first);
+  }
+
+ private:
+  struct Table {
+    std::tuple<uint64_t, uint64_t, uint64_t> key;
+    std::map<uint64_t, std::vector<char>> rows;
+  };
+
+  Index FindOrCreateTable(uint64_t code, uint64_t scope, uint64_t table) {
+    auto key = std::make_tuple(code, scope, table);
+    auto it = table_index_.find(key);
+    if (it != table_index_.end())
+      return it->second;
+    tables_.push_back(Table{key, {}});
+    table_index_[key] = tables_.size() - 1;
+    return tables_.size() - 1;
+  }
+
+  int32_t EndIterator(Index table) { return -static_cast<int32_t>(table) - 2; }
+
+  int32_t AddIterator(Index table, uint64_t id) {
+    iterators_.emplace_back(table, id);
+    return iterators_.size() - 1;
+  }
+
+  std::vector<Table> tables_;
+  std::map<std::tuple<uint64_t, uint64_t, uint64_t>, Index> table_index_;
+  std::vector<std::pair<Index, uint64_t>> iterators_;
+};
+
+// the words of a secondary key, in the order nodeos compares them
+typedef std::vector<uint64_t> SecondaryKey;
+
+static SecondaryKey Idx64Key(const char* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return {v};
+}
+
+static SecondaryKey Idx128Key(const char* p) {
+  uint64_t w[2];
+  memcpy(w, p, sizeof(w));
+  return {w[1], w[0]};
+}
+
+// an array of two uint128_t, compared word by word
+static SecondaryKey Idx256Key(const char* p) {
+  uint64_t w[4];
+  memcpy(w, p, sizeof(w));
+  return {w[1], w[0], w[3], w[2]};
+}
+
+// IEEE floats ordered as unsigned integers; unlike nodeos, -0 and 0 differ
+static SecondaryKey IdxDoubleKey(const char* p) {
+  uint64_t bits;
+  memcpy(&bits, p, sizeof(bits));
+  return {bits >> 63 ? ~bits : bits | (1ull << 63)};
+}
+
+static SecondaryKey IdxLongDoubleKey(const char* p) {
+  uint64_t w[2];
+  memcpy(w, p, sizeof(w));
+  if (w[1] >> 63)
+    return {~w[1], ~w[0]};
+  return {w[1] | (1ull << 63), w[0]};
+}
+
+struct SecondaryIndexType {
+  const char* name;
+  SecondaryKey (*key_of)(const char* secondary);
+  uint32_t size;
+  // the number of words passed along with the key, 0 if no length is passed
+  uint32_t array_size;
+};
+
+static const SecondaryIndexType s_secondary_index_types[] = {
+    {"db_idx64", Idx64Key, 8, 0},
+    {"db_idx128", Idx128Key, 16, 0},
+    {"db_idx256", Idx256Key, 32, 2},
+    {"db_idx_double", IdxDoubleKey, 8, 0},
+    {"db_idx_long_double", IdxLongDoubleKey, 16, 0},
+};
+
+// a secondary index of nodeos, entries are ordered by secondary then primary
+// key and kept in memory for all of the actions of a run
+class SecondaryIndex {
+ public:
+  explicit SecondaryIndex(const SecondaryIndexType* type) : type_(type) {}
+
+  const SecondaryIndexType& type() const { return *type_; }
+
+  int32_t Store(uint64_t code, uint64_t scope, uint64_t table,
+                uint64_t primary, const char* secondary) {
+    Index t = FindOrCreateTable(code, scope, table);
+    Table& entries = tables_[t];
+    auto old = entries.secondaries.find(primary);
+    if (old != entries.secondaries.end())
+      entries.keys.erase(std::make_pair(type_->key_of(old->second.data()), primary));
+    entries.secondaries[primary].assign(secondary, secondary + type_->size);
+    entries.keys.emplace(type_->key_of(secondary), primary);
+    return AddIterator(t, primary);
+  }
+
+  // returns false for end and invalidated iterators
+  bool Update(int32_t itr, const char* secondary) {
+    if (!Valid(itr))
+      return false;
+    Index t = iterators_[itr].first;
+    tables_[t].keys.erase(Entry(itr));
+    tables_[t].secondaries[iterators_[itr].second].assign(
+        secondary, secondary + type_->size);
+    tables_[t].keys.insert(Entry(itr));
+    return true;
+  }
+
+  bool Remove(int32_t itr) {
+    if (!Valid(itr))
+      return false;
+    Index t = iterators_[itr].first;
+    tables_[t].keys.erase(Entry(itr));
+    tables_[t].secondaries.erase(iterators_[itr].second);
+    return true;
+  }
+
+  int32_t Next(int32_t itr, uint64_t* primary) {
+    if (!Valid(itr))
+      return -1;
+    Index t = iterators_[itr].first;
+    auto it = tables_[t].keys.upper_bound(Entry(itr));
+    if (it == tables_[t].keys.end())
+      return EndIterator(t);
+    *primary = it->second;
+    return AddIterator(t, it->second);
+  }
+
+  int32_t Previous(int32_t itr, uint64_t* primary) {
+    Index t;
+    std::set<std::pair<SecondaryKey, uint64_t>>::iterator it;
+    if (itr < -1) {
+      t = -itr - 2;
+      if (t >= tables_.size() || tables_[t].keys.empty())
+        return -1;
+      it = tables_[t].keys.end();
+    } else if (Valid(itr)) {
+      t = iterators_[itr].first;
+      it = tables_[t].keys.find(Entry(itr));
+      if (it == tables_[t].keys.begin())
+        return -1;
+    } else {
+      return -1;
+    }
+    --it;
+    *primary = it->second;
+    return AddIterator(t, it->second);
+  }
+
+  int32_t FindPrimary(uint64_t code, uint64_t scope, uint64_t table,
+                      uint64_t primary, char* secondary) {
+    Index t = FindOrCreateTable(code, scope, table);
+    auto it = tables_[t].secondaries.find(primary);
+    if (it == tables_[t].secondaries.end())
+      return EndIterator(t);
+    memcpy(secondary, it->second.data(), type_->size);
+    return AddIterator(t, primary);
+  }
+
+  int32_t FindSecondary(uint64_t code, uint64_t scope, uint64_t table,
+                        const char* secondary, uint64_t* primary) {
+    Index t = FindOrCreateTable(code, scope, table);
+    SecondaryKey key = type_->key_of(secondary);
+    auto it = tables_[t].keys.lower_bound(std::make_pair(key, uint64_t(0)));
+    if (it == tables_[t].keys.end() || it->first != key)
+      return EndIterator(t);
+    *primary = it->second;
+    return AddIterator(t, it->second);
+  }
+
+  // the bounds write the secondary and primary keys of the entry they find
+  int32_t LowerBound(uint64_t code, uint64_t scope, uint64_t table,
+                     char* secondary, uint64_t* primary) {
+    Index t = FindOrCreateTable(code, scope, table);
+    auto it = tables_[t].keys.lower_bound(
+        std::make_pair(type_->key_of(secondary), uint64_t(0)));
+    return Found(t, it, secondary, primary);
+  }
+
+  int32_t UpperBound(uint64_t code, uint64_t scope, uint64_t table,
+                     char* secondary, uint64_t* primary) {
+    Index t = FindOrCreateTable(code, scope, table);
+    auto it = tables_[t].keys.upper_bound(
+        std::make_pair(type_->key_of(secondary), UINT64_MAX));
+    return Found(t, it, secondary, primary);
+  }
+
+  int32_t End(uint64_t code, uint64_t scope, uint64_t table) {
+    return EndIterator(FindOrCreateTable(code, scope, table));
+  }
+
+ private:
+  struct Table {
+    std::set<std::pair<SecondaryKey, uint64_t>> keys;
+    // raw secondary keys by primary key
+    std::map<uint64_t, std::vector<char>> secondaries;
+  };
+
+  Index FindOrCreateTable(uint64_t code, uint64_t scope, uint64_t table) {
+    auto key = std::make_tuple(code, scope, table);
+    auto it = table_index_.find(key);
+    if (it != table_index_.end())
+      return it->second;
+    tables_.emplace_back();
+    table_index_[key] = tables_.size() - 1;
+    return tables_.size() - 1;
+  }
+
+  bool Valid(int32_t itr) const {
+    return itr >= 0 && static_cast<size_t>(itr) < iterators_.size() &&
+           tables_[iterators_[itr].first].secondaries.count(
+               iterators_[itr].second);
+  }
+
+  std::pair<SecondaryKey, uint64_t> Entry(int32_t itr) const {
+    const Table& t = tables_[iterators_[itr].first];
+    return std::make_pair(
+        type_->key_of(t.secondaries.at(iterators_[itr].second).data()),
+        iterators_[itr].second);
+  }
+
+  int32_t Found(Index t,
+                std::set<std::pair<SecondaryKey, uint64_t>>::iterator it,
+                char* secondary, uint64_t* primary) {
+    if (it == tables_[t].keys.end())
+      return EndIterator(t);
+    memcpy(secondary, tables_[t].secondaries[it->second].data(), type_->size);
+    *primary = it->second;
+    return AddIterator(t, it->second);
+  }
+
+  int32_t EndIterator(Index table) { return -static_cast<int32_t>(table) - 2; }
+
+  int32_t AddIterator(Index table, uint64_t primary) {
+    iterators_.emplace_back(table, primary);
+    return iterators_.size() - 1;
+  }
+
+  const SecondaryIndexType* type_;
+  std::vector<Table> tables_;
+  std::map<std::tuple<uint64_t, uint64_t, uint64_t>, Index> table_index_;
+  std::vector<std::pair<Index, uint64_t>> iterators_;
+};
+
+struct FuncProfile {
+  std::string name;
+  IstreamOffset offset = 0;
+  uint64_t instructions = 0;
+  uint64_t calls = 0;
+  uint64_t host_calls = 0;
+};
+
+struct ImportProfile {
+  ImportProfile(string_view name) : name(name.to_string()), calls(0) {}
+
+  std::string name;
+  uint64_t calls;
+};
+
+class Profiler {
+ public:
+  Profiler(Environment* env) : env_(env) {
+    for (const SecondaryIndexType& type : s_secondary_index_types)
+      secondary_.emplace_back(&type);
+  }
+
+  // stubs of the intrinsics, arguments are the raw wasm values
+  typedef uint64_t (Profiler::*Handler)(const TypedValue* args);
+
+  wabt::Result Run(const std::vector<uint8_t>& wasm, const wabt::Module& ir_module,
+                   const std::vector<RecordedAction>& actions);
+  void Report(Stream* out) const;
+
+  static interp::Result HostCallback(const HostFunc* func,
+                                     const interp::FuncSignature* sig,
+                                     Index num_args,
+                                     TypedValue* args,
+                                     Index num_results,
+                                     TypedValue* out_results,
+                                     void* user_data);
+
+  Index AddHostImport(string_view name) {
+    imports_.emplace_back(name);
+    return imports_.size() - 1;
+  }
+
+  Handler GetHandler(const std::string& name) const;
+
+ private:
+  Index FuncAt(IstreamOffset pc) const;
+
+  char* Memory(uint32_t offset, uint32_t len);
+  uint32_t Abort(const std::string& msg) {
+    abort_message_ = msg;
+    aborted_ = true;
+    return 0;
+  }
+
+  uint64_t ReadActionData(const TypedValue* args) {
+    uint32_t len = std::min<uint32_t>(args[1].value.i32, current_->data.size());
+    if (args[1].value.i32 == 0)
+      return current_->data.size();
+    if (char* p = Memory(args[0].value.i32, len))
+      memcpy(p, current_->data.data(), len);
+    return len;
+  }
+  uint64_t ActionDataSize(const TypedValue*) { return current_->data.size(); }
+  uint64_t CurrentReceiver(const TypedValue*) { return receiver_; }
+  uint64_t True(const TypedValue*) { return 1; }
+  uint64_t CurrentTime(const TypedValue*) { return ++time_; }
+
+  uint64_t Prints(const TypedValue* args) {
+    const std::vector<char>& mem = CurrentMemory()->data;
+    uint32_t offset = args[0].value.i32;
+    uint32_t end = offset;
+    while (end < mem.size() && mem[end])
+      ++end;
+    Print(std::string(mem.begin() + std::min<size_t>(offset, mem.size()),
+                      mem.begin() + end));
+    return 0;
+  }
+  uint64_t PrintsL(const TypedValue* args) {
+    if (char* p = Memory(args[0].value.i32, args[1].value.i32))
+      Print(std::string(p, args[1].value.i32));
+    return 0;
+  }
+  uint64_t Printi(const TypedValue* args) {
+    Print(std::to_string(static_cast<int64_t>(args[0].value.i64)));
+    return 0;
+  }
+  uint64_t Printui(const TypedValue* args) {
+    Print(std::to_string(args[0].value.i64));
+    return 0;
+  }
+  uint64_t Printn(const TypedValue* args) {
+    Print(NameToString(args[0].value.i64));
+    return 0;
+  }
+
+  uint64_t EosioAssert(const TypedValue* args) {
+    if (!args[0].value.i32) {
+      const std::vector<char>& mem = CurrentMemory()->data;
+      uint32_t offset = args[1].value.i32, end = offset;
+      while (end < mem.size() && mem[end])
+        ++end;
+      Abort("assertion failure with message: " +
+            std::string(mem.begin() + std::min<size_t>(offset, mem.size()),
+                        mem.begin() + end));
+    }
+    return 0;
+  }
+  uint64_t EosioAssertMessage(const TypedValue* args) {
+    if (!args[0].value.i32) {
+      char* p = Memory(args[1].value.i32, args[2].value.i32);
+      Abort("assertion failure with message: " +
+            (p ? std::string(p, args[2].value.i32) : std::string()));
+    }
+    return 0;
+  }
+  uint64_t EosioAssertCode(const TypedValue* args) {
+    if (!args[0].value.i32)
+      Abort("assertion failure with error code: " +
+            std::to_string(args[1].value.i64));
+    return 0;
+  }
+  uint64_t EosioExit(const TypedValue*) {
+    exited_ = true;
+    return 0;
+  }
+  uint64_t AbortCalled(const TypedValue*) { return Abort("abort() called"); }
+
+  uint64_t Memcpy(const TypedValue* args) {
+    char* dst = Memory(args[0].value.i32, args[2].value.i32);
+    char* src = Memory(args[1].value.i32, args[2].value.i32);
+    if (dst && src)
+      memmove(dst, src, args[2].value.i32);
+    return args[0].value.i32;
+  }
+  uint64_t Memset(const TypedValue* args) {
+    if (char* dst = Memory(args[0].value.i32, args[2].value.i32))
+      memset(dst, args[1].value.i32, args[2].value.i32);
+    return args[0].value.i32;
+  }
+  uint64_t Memcmp(const TypedValue* args) {
+    char* lhs = Memory(args[0].value.i32, args[2].value.i32);
+    char* rhs = Memory(args[1].value.i32, args[2].value.i32);
+    int ret = lhs && rhs ? memcmp(lhs, rhs, args[2].value.i32) : 0;
+    return static_cast<uint32_t>(ret < 0 ? -1 : ret > 0 ? 1 : 0);
+  }
+
+  template <typename T>
+  uint64_t Int128(const TypedValue* args, T (*op)(T, T)) {
+    T lhs = static_cast<T>((static_cast<unsigned __int128>(args[2].value.i64) << 64) | args[1].value.i64);
+    T rhs = static_cast<T>((static_cast<unsigned __int128>(args[4].value.i64) << 64) | args[3].value.i64);
+    if (!op)
+      return Abort("divide by zero");
+    if (char* p = Memory(args[0].value.i32, 16)) {
+      T ret = op(lhs, rhs);
+      memcpy(p, &ret, 16);
+    }
+    return 0;
+  }
+  uint64_t Multi3(const TypedValue* args) {
+    return Int128<__int128>(args, [](__int128 a, __int128 b) { return a * b; });
+  }
+  uint64_t Divti3(const TypedValue* args) {
+    bool zero = !args[3].value.i64 && !args[4].value.i64;
+    return Int128<__int128>(args, zero ? nullptr : +[](__int128 a, __int128 b) { return a / b; });
+  }
+  uint64_t Udivti3(const TypedValue* args) {
+    bool zero = !args[3].value.i64 && !args[4].value.i64;
+    return Int128<unsigned __int128>(args, zero ? nullptr : +[](unsigned __int128 a, unsigned __int128 b) { return a / b; });
+  }
+  uint64_t Modti3(const TypedValue* args) {
+    bool zero = !args[3].value.i64 && !args[4].value.i64;
+    return Int128<__int128>(args, zero ? nullptr : +[](__int128 a, __int128 b) { return a % b; });
+  }
+  uint64_t Umodti3(const TypedValue* args) {
+    bool zero = !args[3].value.i64 && !args[4].value.i64;
+    return Int128<unsigned __int128>(args, zero ? nullptr : +[](unsigned __int128 a, unsigned __int128 b) { return a % b; });
+  }
+
+  uint64_t DbStore(const TypedValue* args) {
+    char* p = Memory(args[4].value.i32, args[5].value.i32);
+    if (!p)
+      return 0;
+    return static_cast<uint32_t>(db_.Store(receiver_, args[0].value.i64, args[1].value.i64,
+                                           args[3].value.i64, p, args[5].value.i32));
+  }
+  uint64_t DbUpdate(const TypedValue* args) {
+    std::vector<char>* row = db_.Row(args[0].value.i32);
+    char* p = Memory(args[2].value.i32, args[3].value.i32);
+    if (!row)
+      return Abort("db_update_i64 called with an invalid iterator");
+    if (p)
+      row->assign(p, p + args[3].value.i32);
+    return 0;
+  }
+  uint64_t DbRemove(const TypedValue* args) {
+    if (!db_.Row(args[0].value.i32))
+      return Abort("db_remove_i64 called with an invalid iterator");
+    db_.Remove(args[0].value.i32);
+    return 0;
+  }
+  uint64_t DbGet(const TypedValue* args) {
+    std::vector<char>* row = db_.Row(args[0].value.i32);
+    if (!row)
+      return Abort("db_get_i64 called with an invalid iterator");
+    uint32_t len = args[2].value.i32;
+    if (len == 0)
+      return row->size();
+    len = std::min<uint32_t>(len, row->size());
+    if (char* p = Memory(args[1].value.i32, len))
+      memcpy(p, row->data(), len);
+    return len;
+  }
+  uint64_t DbNext(const TypedValue* args) {
+    uint64_t id;
+    int32_t itr = db_.Next(args[0].value.i32, &id);
+    if (itr >= 0)
+      if (char* p = Memory(args[1].value.i32, sizeof(id)))
+        memcpy(p, &id, sizeof(id));
+    return static_cast<uint32_t>(itr);
+  }
+  uint64_t DbPrevious(const TypedValue* args) {
+    uint64_t id;
+    int32_t itr = db_.Previous(args[0].value.i32, &id);
+    if (itr >= 0)
+      if (char* p = Memory(args[1].value.i32, sizeof(id)))
+        memcpy(p, &id, sizeof(id));
+    return static_cast<uint32_t>(itr);
+  }
+  uint64_t DbFind(const TypedValue* args) {
+    return static_cast<uint32_t>(db_.Find(args[0].value.i64, args[1].value.i64,
+                                          args[2].value.i64, args[3].value.i64));
+  }
+  uint64_t DbLowerBound(const TypedValue* args) {
+    return static_cast<uint32_t>(db_.LowerBound(args[0].value.i64, args[1].value.i64,
+                                                args[2].value.i64, args[3].value.i64));
+  }
+  uint64_t DbUpperBound(const TypedValue* args) {
+    return static_cast<uint32_t>(db_.UpperBound(args[0].value.i64, args[1].value.i64,
+                                                args[2].value.i64, args[3].value.i64));
+  }
+  uint64_t DbEnd(const TypedValue* args) {
+    return static_cast<uint32_t>(db_.End(args[0].value.i64, args[1].value.i64,
+                                         args[2].value.i64));
+  }
+
+  // the secondary key argument of index I at args[0], followed by its length
+  // for the array keys
+  template <int I>
+  char* SecondaryKeyArg(const TypedValue* args) {
+    const SecondaryIndexType& type = secondary_[I].type();
+    if (type.array_size && args[1].value.i32 != type.array_size) {
+      Abort(std::string(type.name) + " called with an invalid key size");
+      return nullptr;
+    }
+    return Memory(args[0].value.i32, type.size);
+  }
+  // the primary key argument following the secondary key of index I at args[0]
+  template <int I>
+  const TypedValue& PrimaryKeyArg(const TypedValue* args) {
+    return args[secondary_[I].type().array_size ? 2 : 1];
+  }
+  uint32_t WritePrimaryKey(int32_t itr, uint32_t offset, uint64_t primary) {
+    if (itr >= 0)
+      if (char* p = Memory(offset, sizeof(primary)))
+        memcpy(p, &primary, sizeof(primary));
+    return static_cast<uint32_t>(itr);
+  }
+
+  template <int I>
+  uint64_t DbIdxStore(const TypedValue* args) {
+    const char* secondary = SecondaryKeyArg<I>(args + 4);
+    if (!secondary)
+      return 0;
+    return static_cast<uint32_t>(secondary_[I].Store(
+        receiver_, args[0].value.i64, args[1].value.i64, args[3].value.i64,
+        secondary));
+  }
+  template <int I>
+  uint64_t DbIdxUpdate(const TypedValue* args) {
+    const char* secondary = SecondaryKeyArg<I>(args + 2);
+    if (secondary && !secondary_[I].Update(args[0].value.i32, secondary))
+      return Abort(std::string(secondary_[I].type().name) +
+                   "_update called with an invalid iterator");
+    return 0;
+  }
+  template <int I>
+  uint64_t DbIdxRemove(const TypedValue* args) {
+    if (!secondary_[I].Remove(args[0].value.i32))
+      return Abort(std::string(secondary_[I].type().name) +
+                   "_remove called with an invalid iterator");
+    return 0;
+  }
+  template <int I>
+  uint64_t DbIdxNext(const TypedValue* args) {
+    uint64_t primary;
+    int32_t itr = secondary_[I].Next(args[0].value.i32, &primary);
+    return WritePrimaryKey(itr, args[1].value.i32, primary);
+  }
+  template <int I>
+  uint64_t DbIdxPrevious(const TypedValue* args) {
+    uint64_t primary;
+    int32_t itr = secondary_[I].Previous(args[0].value.i32, &primary);
+    return WritePrimaryKey(itr, args[1].value.i32, primary);
+  }
+  template <int I>
+  uint64_t DbIdxFindPrimary(const TypedValue* args) {
+    char* secondary = SecondaryKeyArg<I>(args + 3);
+    if (!secondary)
+      return 0;
+    return static_cast<uint32_t>(secondary_[I].FindPrimary(
+        args[0].value.i64, args[1].value.i64, args[2].value.i64,
+        PrimaryKeyArg<I>(args + 3).value.i64, secondary));
+  }
+  template <int I>
+  uint64_t DbIdxFindSecondary(const TypedValue* args) {
+    const char* secondary = SecondaryKeyArg<I>(args + 3);
+    if (!secondary)
+      return 0;
+    uint64_t primary;
+    int32_t itr = secondary_[I].FindSecondary(
+        args[0].value.i64, args[1].value.i64, args[2].value.i64, secondary,
+        &primary);
+    return WritePrimaryKey(itr, PrimaryKeyArg<I>(args + 3).value.i32, primary);
+  }
+  template <int I>
+  uint64_t DbIdxLowerBound(const TypedValue* args) {
+    char* secondary = SecondaryKeyArg<I>(args + 3);
+    if (!secondary)
+      return 0;
+    uint64_t primary;
+    int32_t itr = secondary_[I].LowerBound(
+        args[0].value.i64, args[1].value.i64, args[2].value.i64, secondary,
+        &primary);
+    return WritePrimaryKey(itr, PrimaryKeyArg<I>(args + 3).value.i32, primary);
+  }
+  template <int I>
+  uint64_t DbIdxUpperBound(const TypedValue* args) {
+    char* secondary = SecondaryKeyArg<I>(args + 3);
+    if (!secondary)
+      return 0;
+    uint64_t primary;
+    int32_t itr = secondary_[I].UpperBound(
+        args[0].value.i64, args[1].value.i64, args[2].value.i64, secondary,
+        &primary);
+    return WritePrimaryKey(itr, PrimaryKeyArg<I>(args + 3).value.i32, primary);
+  }
+  template <int I>
+  uint64_t DbIdxEnd(const TypedValue* args) {
+    return static_cast<uint32_t>(secondary_[I].End(
+        args[0].value.i64, args[1].value.i64, args[2].value.i64));
+  }
+  // the handler of the intrinsic `op` of the secondary index I, e.g. `store`
+  template <int I>
+  static Handler SecondaryIndexHandler(const std::string& op) {
+    static const std::map<std::string, Handler> handlers = {
+        {"store", &Profiler::DbIdxStore<I>},
+        {"update", &Profiler::DbIdxUpdate<I>},
+        {"remove", &Profiler::DbIdxRemove<I>},
+        {"next", &Profiler::DbIdxNext<I>},
+        {"previous", &Profiler::DbIdxPrevious<I>},
+        {"find_primary", &Profiler::DbIdxFindPrimary<I>},
+        {"find_secondary", &Profiler::DbIdxFindSecondary<I>},
+        {"lowerbound", &Profiler::DbIdxLowerBound<I>},
+        {"upperbound", &Profiler::DbIdxUpperBound<I>},
+        {"end", &Profiler::DbIdxEnd<I>},
+    };
+    auto it = handlers.find(op);
+    return it != handlers.end() ? it->second : &Profiler::Zero;
+  }
+
+  uint64_t Zero(const TypedValue*) { return 0; }
+
+  void Print(const std::string& s) {
+    if (s_print)
+      fwrite(s.data(), 1, s.size(), stdout);
+  }
+
+  interp::Memory* CurrentMemory() {
+    return env_->GetMemory(module_->memory_index);
+  }
+
+  Environment* env_;
+  DefinedModule* module_ = nullptr;
+  const RecordedAction* current_ = nullptr;
+  uint64_t receiver_ = 0;
+  uint64_t time_ = 1546300800000000ull;
+  Database db_;
+  // indexed like s_secondary_index_types
+  std::vector<SecondaryIndex> secondary_;
+  bool aborted_ = false;
+  bool exited_ = false;
+  std::string abort_message_;
+
+  Index func_base_ = 0;
+  std::vector<FuncProfile> funcs_;
+  std::vector<Index> funcs_by_offset_;
+  std::vector<ImportProfile> imports_;
+  std::vector<Index> call_stack_;
+  // backward branches, keyed by function and target
+  std::map<std::pair<Index, IstreamOffset>, uint64_t> loops_;
+  std::vector<std::string> results_;
+  uint64_t total_instructions_ = 0;
+};
+
+struct HostBinding {
+  Profiler* profiler;
+  Profiler::Handler handler;
+  Index import;
+};
+
+static std::vector<std::unique_ptr<HostBinding>> s_bindings;
+
+Profiler::Handler Profiler::GetHandler(const std::string& name) const {
+  static const std::map<std::string, Handler> handlers = {
+      {"read_action_data", &Profiler::ReadActionData},
+      {"action_data_size", &Profiler::ActionDataSize},
+      {"current_receiver", &Profiler::CurrentReceiver},
+      {"has_auth", &Profiler::True},
+      {"is_account", &Profiler::True},
+      {"current_time", &Profiler::CurrentTime},
+      {"publication_time", &Profiler::CurrentTime},
+      {"prints", &Profiler::Prints},
+      {"prints_l", &Profiler::PrintsL},
+      {"printi", &Profiler::Printi},
+      {"printui", &Profiler::Printui},
+      {"printn", &Profiler::Printn},
+      {"eosio_assert", &Profiler::EosioAssert},
+      {"eosio_assert_message", &Profiler::EosioAssertMessage},
+      {"eosio_assert_code", &Profiler::EosioAssertCode},
+      {"eosio_exit", &Profiler::EosioExit},
+      {"abort", &Profiler::AbortCalled},
+      {"memcpy", &Profiler::Memcpy},
+      {"memmove", &Profiler::Memcpy},
+      {"memset", &Profiler::Memset},
+      {"memcmp", &Profiler::Memcmp},
+      {"__multi3", &Profiler::Multi3},
+      {"__divti3", &Profiler::Divti3},
+      {"__udivti3", &Profiler::Udivti3},
+      {"__modti3", &Profiler::Modti3},
+      {"__umodti3", &Profiler::Umodti3},
+      {"db_store_i64", &Profiler::DbStore},
+      {"db_update_i64", &Profiler::DbUpdate},
+      {"db_remove_i64", &Profiler::DbRemove},
+      {"db_get_i64", &Profiler::DbGet},
+      {"db_next_i64", &Profiler::DbNext},
+      {"db_previous_i64", &Profiler::DbPrevious},
+      {"db_find_i64", &Profiler::DbFind},
+      {"db_lowerbound_i64", &Profiler::DbLowerBound},
+      {"db_upperbound_i64", &Profiler::DbUpperBound},
+      {"db_end_i64", &Profiler::DbEnd},
+  };
+  auto it = handlers.find(name);
+  if (it != handlers.end())
+    return it->second;
+  static Handler (*const secondary_index_handlers[])(const std::string&) = {
+      &Profiler::SecondaryIndexHandler<0>, &Profiler::SecondaryIndexHandler<1>,
+      &Profiler::SecondaryIndexHandler<2>, &Profiler::SecondaryIndexHandler<3>,
+      &Profiler::SecondaryIndexHandler<4>,
+  };
+  static_assert(sizeof(secondary_index_handlers) / sizeof(*secondary_index_handlers) ==
+                    sizeof(s_secondary_index_types) / sizeof(*s_secondary_index_types),
+                "a handler is needed for every secondary index");
+  for (size_t i = 0; i < sizeof(s_secondary_index_types) / sizeof(*s_secondary_index_types); ++i) {
+    std::string prefix = std::string(s_secondary_index_types[i].name) + "_";
+    if (name.compare(0, prefix.size(), prefix) == 0)
+      return secondary_index_handlers[i](name.substr(prefix.size()));
+  }
+  return &Profiler::Zero;
+}
+
+class ProfileHostImportDelegate : public HostImportDelegate {
+ public:
+  explicit ProfileHostImportDelegate(Profiler* profiler)
+      : profiler_(profiler) {}
+
+  wabt::Result ImportFunc(interp::FuncImport* import,
+                          interp::Func* func,
+                          interp::FuncSignature* func_sig,
+                          const ErrorCallback& callback) override {
+    // every action re-instantiates the module, reuse the bindings
+    Index index = bindings_.size();
+    auto key = import->field_name;
+    auto it = by_name_.find(key);
+    if (it != by_name_.end()) {
+      index = it->second;
+    } else {
+      s_bindings.emplace_back(new HostBinding{
+          profiler_, profiler_->GetHandler(import->field_name),
+          profiler_->AddHostImport(import->field_name)});
+      bindings_.push_back(s_bindings.back().get());
+      by_name_[key] = index;
+    }
+    cast<HostFunc>(func)->callback = Profiler::HostCallback;
+    cast<HostFunc>(func)->user_data = bindings_[index];
+    return wabt::Result::Ok;
+  }
+
+  wabt::Result ImportTable(interp::TableImport*, interp::Table*,
+                           const ErrorCallback& callback) override {
+    callback("only functions can be imported");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportMemory(interp::MemoryImport*, interp::Memory*,
+                            const ErrorCallback& callback) override {
+    callback("only functions can be imported");
+    return wabt::Result::Error;
+  }
+
+  wabt::Result ImportGlobal(interp::GlobalImport*, interp::Global*,
+                            const ErrorCallback& callback) override {
+    callback("only functions can be imported");
+    return wabt::Result::Error;
+  }
+
+ private:
+  Profiler* profiler_;
+  std::vector<HostBinding*> bindings_;
+  std::map<std::string, Index> by_name_;
+};
+
+interp::Result Profiler::HostCallback(const HostFunc* func,
+                                      const interp::FuncSignature* sig,
+                                      Index num_args,
+                                      TypedValue* args,
+                                      Index num_results,
+                                      TypedValue* out_results,
+                                      void* user_data) {
+  auto* binding = static_cast<HostBinding*>(user_data);
+  Profiler* self = binding->profiler;
+  self->imports_[binding->import].calls++;
+  if (!self->call_stack_.empty())
+    self->funcs_[self->call_stack_.back()].host_calls++;
+
+  uint64_t ret = 0;
+  if (!self->aborted_ && !self->exited_)
+    ret = (self->*(binding->handler))(args);
+
+  memset(static_cast<void*>(out_results), 0, sizeof(TypedValue) * num_results);
+  for (Index i = 0; i < num_results; ++i) {
+    out_results[i].type = sig->result_types[i];
+    if (out_results[i].type == Type::I32)
+      out_results[i].value.i32 = static_cast<uint32_t>(ret);
+    else if (out_results[i].type == Type::I64)
+      out_results[i].value.i64 = ret;
+  }
+  return self->aborted_ ? interp::Result::TrapHostTrapped : interp::Result::Ok;
+}
+
+char* Profiler::Memory(uint32_t offset, uint32_t len) {
+  std::vector<char>& mem = CurrentMemory()->data;
+  if (static_cast<uint64_t>(offset) + len > mem.size()) {
+    Abort("access violation");
+    return nullptr;
+  }
+  return mem.data() + offset;
+}
+
+Index Profiler::FuncAt(IstreamOffset pc) const {
+  auto it = std::upper_bound(
+      funcs_by_offset_.begin(), funcs_by_offset_.end(), pc,
+      [this](IstreamOffset pc, Index f) { return pc < funcs_[f].offset; });
+  return it == funcs_by_offset_.begin() ? 0 : *(it - 1);
+}
+
+static bool IsBranch(Opcode opcode) {
+  return opcode == Opcode::Br || opcode == Opcode::BrIf ||
+         opcode == Opcode::BrTable || opcode == Opcode::InterpBrUnless;
+}
+
+// mirrors ReadOpcode in interp.cc
+static Opcode ReadOpcodeAt(const uint8_t* pc) {
+  uint8_t value = pc[0];
+  if (Opcode::IsPrefixByte(value))
+    return Opcode::FromCode(value, pc[1]);
+  return Opcode::FromCode(value);
+}
+
+wabt::Result Profiler::Run(const std::vector<uint8_t>& wasm,
+                           const wabt::Module& ir_module,
+                           const std::vector<RecordedAction>& actions) {
+  receiver_ = StringToName(s_receiver);
+  Environment::MarkPoint mark = env_->Mark();
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = true;
+  ReadBinaryOptions options(s_features, s_log_stream.get(), kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+
+  for (const RecordedAction& action : actions) {
+    // start every action with the initial memory and globals, like nodeos
+    env_->ResetToMarkPoint(mark);
+    func_base_ = env_->GetFuncCount();
+    CHECK_RESULT(ReadBinaryInterp(env_, wasm.data(), wasm.size(), &options,
+                                  &error_handler, &module_));
+
+    if (funcs_.empty()) {
+      for (Index i = 0; i < ir_module.funcs.size(); ++i) {
+        FuncProfile profile;
+        profile.name = ir_module.funcs[i]->name.empty()
+                           ? "func[" + std::to_string(i) + "]"
+                           : ir_module.funcs[i]->name;
+        if (profile.name[0] == '$')
+          profile.name.erase(0, 1);
+        interp::Func* func = env_->GetFunc(func_base_ + i);
+        if (auto* defined = dyn_cast<DefinedFunc>(func)) {
+          profile.offset = defined->offset;
+          funcs_by_offset_.push_back(i);
+        }
+        funcs_.push_back(profile);
+      }
+      std::sort(funcs_by_offset_.begin(), funcs_by_offset_.end(),
+                [this](Index a, Index b) {
+                  return funcs_[a].offset < funcs_[b].offset;
+                });
+    }
+
+    interp::Export* apply = module_->GetExport("apply");
+    if (!apply || apply->kind != ExternalKind::Func) {
+      fprintf(stderr, "error: contract doesn't export an `apply` function\n");
+      return wabt::Result::Error;
+    }
+    auto* func = dyn_cast<DefinedFunc>(env_->GetFunc(apply->index));
+    if (!func) {
+      fprintf(stderr, "error: `apply` is an import\n");
+      return wabt::Result::Error;
+    }
+
+    current_ = &action;
+    aborted_ = exited_ = false;
+    call_stack_.clear();
+
+    Thread thread(env_);
+    Value value;
+    for (uint64_t arg : {receiver_, action.code, action.name}) {
+      value.i64 = arg;
+      if (thread.Push(value) != interp::Result::Ok)
+        return wabt::Result::Error;
+    }
+
+    Index apply_index = apply->index - func_base_;
+    funcs_[apply_index].calls++;
+    call_stack_.push_back(apply_index);
+    thread.set_pc(func->offset);
+
+    const uint8_t* istream = env_->istream().data.data();
+    uint64_t instructions = 0;
+    interp::Result result = interp::Result::Ok;
+    while (result == interp::Result::Ok && !aborted_ && !exited_) {
+      IstreamOffset pc = thread.pc();
+      Opcode opcode = ReadOpcodeAt(istream + pc);
+      if (opcode != Opcode::InterpAlloca && opcode != Opcode::InterpDropKeep &&
+          opcode != Opcode::InterpData) {
+        funcs_[call_stack_.back()].instructions++;
+        instructions++;
+      }
+
+      result = thread.Run(1);
+      if (result != interp::Result::Ok)
+        break;
+
+      IstreamOffset next = thread.pc();
+      if (opcode == Opcode::Call || opcode == Opcode::CallIndirect) {
+        // calls of imports don't change the pc
+        if (next != pc + 1 + sizeof(uint32_t) * (opcode == Opcode::Call ? 1 : 2)) {
+          Index callee = FuncAt(next);
+          funcs_[callee].calls++;
+          call_stack_.push_back(callee);
+        }
+      } else if (opcode == Opcode::Return) {
+        call_stack_.pop_back();
+      } else if (IsBranch(opcode) && next <= pc) {
+        loops_[std::make_pair(call_stack_.back(), next)]++;
+      }
+    }
+    total_instructions_ += instructions;
+
+    std::string status;
+    if (aborted_)
+      status = abort_message_;
+    else if (result == interp::Result::Ok || result == interp::Result::Returned)
+      status = "ok";
+    else
+      status = ResultToString(result);
+    results_.push_back(NameToString(action.code) + "::" +
+                       NameToString(action.name) + " " +
+                       std::to_string(instructions) + " instructions, " +
+                       status);
+  }
+  return wabt::Result::Ok;
+}
+
+static std::string Percent(uint64_t part, uint64_t total) {
+  return StringPrintf("%5.1f%%", total ? 100.0 * part / total : 0.0);
+}
+
+void Profiler::Report(Stream* out) const {
+  out->Writef("Actions:\n");
+  for (const std::string& result : results_)
+    out->Writef("  %s\n", result.c_str());
+  out->Writef("  total %" PRIu64 " instructions\n\n", total_instructions_);
+
+  std::vector<const FuncProfile*> funcs;
+  for (const FuncProfile& func : funcs_)
+    if (func.instructions)
+      funcs.push_back(&func);
+  std::sort(funcs.begin(), funcs.end(),
+            [](const FuncProfile* a, const FuncProfile* b) {
+              return a->instructions > b->instructions;
+            });
+  out->Writef("Functions by instructions:\n");
+  out->Writef("  %14s %6s %10s %10s  %s\n", "instructions", "", "calls",
+              "host calls", "function");
+  for (size_t i = 0; i < funcs.size() && i < static_cast<size_t>(s_top); ++i)
+    out->Writef("  %14" PRIu64 " %s %10" PRIu64 " %10" PRIu64 "  %s\n",
+                funcs[i]->instructions,
+                Percent(funcs[i]->instructions, total_instructions_).c_str(),
+                funcs[i]->calls, funcs[i]->host_calls, funcs[i]->name.c_str());
+
+  std::vector<std::pair<std::pair<Index, IstreamOffset>, uint64_t>> loops(
+      loops_.begin(), loops_.end());
+  std::sort(loops.begin(), loops.end(),
+            [](const std::pair<std::pair<Index, IstreamOffset>, uint64_t>& a,
+               const std::pair<std::pair<Index, IstreamOffset>, uint64_t>& b) {
+              return a.second > b.second;
+            });
+  out->Writef("\nHot loops:\n");
+  out->Writef("  %14s  %s\n", "iterations", "function+offset");
+  for (size_t i = 0; i < loops.size() && i < static_cast<size_t>(s_top); ++i) {
+    const FuncProfile& func = funcs_[loops[i].first.first];
+    out->Writef("  %14" PRIu64 "  %s+0x%x\n", loops[i].second,
+                func.name.c_str(), loops[i].first.second - func.offset);
+  }
+
+  std::vector<const ImportProfile*> imports;
+  for (const ImportProfile& import : imports_)
+    if (import.calls)
+      imports.push_back(&import);
+  std::sort(imports.begin(), imports.end(),
+            [](const ImportProfile* a, const ImportProfile* b) {
+              return a->calls > b->calls;
+            });
+  out->Writef("\nIntrinsic calls:\n");
+  out->Writef("  %14s  %s\n", "calls", "intrinsic");
+  for (const ImportProfile* import : imports)
+    out->Writef("  %14" PRIu64 "  %s\n", import->calls, import->name.c_str());
+}
+
+int ProgramMain(int argc, char** argv) {
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  wabt::Result result = ReadFile(s_infile.c_str(), &file_data);
+  if (Failed(result))
+    return 1;
+
+  std::vector<RecordedAction> actions;
+  result = ReadActions(s_actions_file, &actions);
+  if (Failed(result))
+    return 1;
+
+  // the IR is only used for the names of the functions
+  ErrorHandlerFile error_handler(Location::Type::Binary);
+  wabt::Module ir_module;
+  const bool kReadDebugNames = true;
+  const bool kStopOnFirstError = true;
+  const bool kFailOnCustomSectionError = false;
+  ReadBinaryOptions options(s_features, s_log_stream.get(), kReadDebugNames,
+                            kStopOnFirstError, kFailOnCustomSectionError);
+  result = ReadBinaryIr(s_infile.c_str(), file_data.data(), file_data.size(),
+                        &options, &error_handler, &ir_module);
+  if (Failed(result))
+    return 1;
+
+  Environment env;
+  Profiler profiler(&env);
+  HostModule* host_module = env.AppendHostModule("env");
+  host_module->import_delegate.reset(new ProfileHostImportDelegate(&profiler));
+
+  result = profiler.Run(file_data, ir_module, actions);
+  if (Failed(result))
+    return 1;
+
+  std::unique_ptr<FileStream> out = FileStream::CreateStdout();
+  profiler.Report(out.get());
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2017 WebAssembly Community Group participants
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cassert>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+
+#include "src/apply-names.h"
+#include "src/binary-reader.h"
+#include "src/binary-reader-ir.h"
+#include "src/cast.h"
+#include "src/error-handler.h"
+#include "src/feature.h"
+#include "src/generate-names.h"
+#include "src/ir.h"
+#include "src/option-parser.h"
+#include "src/stream.h"
+#include "src/validator.h"
+#include "src/wast-lexer.h"
+
+#include "src/c-writer.h"
+
+using namespace wabt;
+
+static int s_verbose;
+static std::string s_infile;
+static std::string s_outfile;
+static Features s_features;
+static WriteCOptions s_write_c_options;
+static bool s_read_debug_names = true;
+static std::unique_ptr<FileStream> s_log_stream;
+
+static const char s_description[] =
+R"(  Read a contract in the WebAssembly binary format and translate it to C with
+  wasm2c, along with a C++ glue file which binds the contract imports to the
+  intrinsics of the native tester (libraries/native) and defines `apply`.
+
+  The three outputs are compiled with `eosio-cpp -fnative` and linked into a
+  native unit test in place of the contract sources.
+
+examples:
+  # parse hello.wasm and write hello.c, hello.h and hello_glue.cpp
+  $ eosio-wasm2native hello.wasm -o hello.c
+)";
+
+// imports which nodeos implements itself rather than as intrinsics,
+// see eosio/native/wasm2native.hpp
+static const std::set<std::string> s_builtins = {
+    "__ashlti3", "__ashrti3", "__lshlti3", "__lshrti3", "__divti3",
+    "__udivti3", "__modti3",  "__umodti3", "__multi3",  "memcpy",
+    "memmove",   "memcmp",    "memset",    "abort"};
+
+static void ParseOptions(int argc, char** argv) {
+  OptionParser parser("eosio-wasm2native", s_description);
+
+  parser.AddOption('v', "verbose", "Use multiple times for more info", []() {
+    s_verbose++;
+    s_log_stream = FileStream::CreateStdout();
+  });
+  parser.AddHelpOption();
+  parser.AddOption(
+      'o', "output", "FILENAME",
+      "Output file for the generated C source file, the header and the glue "
+      "file are written next to it",
+      [](const char* argument) {
+        s_outfile = argument;
+        ConvertBackslashToSlash(&s_outfile);
+      });
+  parser.AddOption("no-debug-names", "Ignore debug names in the binary file",
+                   []() { s_read_debug_names = false; });
+  parser.AddArgument("filename", OptionParser::ArgumentCount::One,
+                     [](const char* argument) {
+                       s_infile = argument;
+                       ConvertBackslashToSlash(&s_infile);
+                     });
+  parser.Parse(argc, argv);
+
+  if (s_outfile.empty()) {
+    fprintf(stderr, "eosio-wasm2native requires an output file (-o).\n");
+    exit(1);
+  }
+}
+
+static std::string StripExtension(const std::string& s) {
+  size_t pos = s.find_last_of('.');
+  if (pos != std::string::npos && s.substr(pos) == ".c")
+    return s.substr(0, pos);
+  return s;
+}
+
+static std::string BaseName(const std::string& s) {
+  size_t pos = s.find_last_of('/');
+  return pos == std::string::npos ? s : s.substr(pos + 1);
+}
+
+// these mirror the name mangling of the wasm2c c-writer
+static std::string MangleName(string_view name) {
+  std::string result = "Z_";
+  for (char c : name) {
+    if ((isalnum(c) && c != 'Z') || c == '_') {
+      result += c;
+    } else {
+      result += 'Z';
+      result += StringPrintf("%02X", static_cast<uint8_t>(c));
+    }
+  }
+  return result;
+}
+
+static char MangleType(Type type) {
+  switch (type) {
+    case Type::I32: return 'i';
+    case Type::I64: return 'j';
+    case Type::F32: return 'f';
+    case Type::F64: return 'd';
+    default: WABT_UNREACHABLE;
+  }
+}
+
+static std::string MangleFuncName(string_view name, const FuncSignature& sig) {
+  std::string types;
+  if (sig.result_types.empty())
+    types += 'v';
+  for (Type type : sig.result_types)
+    types += MangleType(type);
+  if (sig.param_types.empty())
+    types += 'v';
+  for (Type type : sig.param_types)
+    types += MangleType(type);
+  return MangleName(name) + MangleName(types);
+}
+
+static std::string LegalizeName(string_view name) {
+  std::string result = name.empty() || !isalpha(name[0]) ? "_" : "";
+  for (char c : name)
+    result += isalnum(c) ? c : '_';
+  return result;
+}
+
+static const char* CType(Type type) {
+  switch (type) {
+    case Type::I32: return "u32";
+    case Type::I64: return "u64";
+    case Type::F32: return "f32";
+    case Type::F64: return "f64";
+    default: WABT_UNREACHABLE;
+  }
+}
+
+static std::string CResultType(const FuncSignature& sig) {
+  return sig.result_types.empty() ? "void" : CType(sig.result_types[0]);
+}
+
+static std::string CParams(const FuncSignature& sig, bool with_names) {
+  std::string result;
+  for (size_t i = 0; i < sig.param_types.size(); ++i) {
+    if (i)
+      result += ", ";
+    result += CType(sig.param_types[i]);
+    if (with_names)
+      result += " a" + std::to_string(i);
+  }
+  return result.empty() && !with_names ? "void" : result;
+}
+
+// contracts built by eosio-ld don't always export their memory, but the glue
+// needs it to translate pointers
+static void ExportMemory(Module* module) {
+  if (module->memories.empty())
+    return;
+  for (const Export* export_ : module->exports)
+    if (export_->kind == ExternalKind::Memory)
+      return;
+  auto field = MakeUnique<ExportModuleField>();
+  field->export_.name = "memory";
+  field->export_.kind = ExternalKind::Memory;
+  field->export_.var = Var(0);
+  module->AppendField(std::move(field));
+}
+
+static std::string MemoryExportName(const Module& module) {
+  for (const Export* export_ : module.exports)
+    if (export_->kind == ExternalKind::Memory)
+      return MangleName(export_->name);
+  return std::string();
+}
+
+static Result WriteGlue(Stream* stream,
+                        const std::string& header_name,
+                        const Module& module) {
+  Result result = Result::Ok;
+  stream->Writef("/* Generated by eosio-wasm2native from '%s', do not edit! */\n",
+                 BaseName(s_infile).c_str());
+  stream->Writef("#include \"%s\"\n", header_name.c_str());
+  stream->Writef("#include <eosio/wasm2native.hpp>\n\n");
+  stream->Writef("using namespace eosio::native::wasm2native;\n\n");
+
+  Index index = 0;
+  for (const Import* import : module.imports) {
+    if (import->kind() != ExternalKind::Func) {
+      fprintf(stderr, "error: unsupported import '%s.%s', only functions can be imported\n",
+              import->module_name.c_str(), import->field_name.c_str());
+      result = Result::Error;
+      continue;
+    }
+    const FuncSignature& sig = cast<FuncImport>(import)->func.decl.sig;
+    if (sig.result_types.size() > 1) {
+      fprintf(stderr, "error: import '%s.%s' has multiple results\n",
+              import->module_name.c_str(), import->field_name.c_str());
+      result = Result::Error;
+      continue;
+    }
+
+    std::string wrapper = "import_" + std::to_string(index++) + "_" +
+                          LegalizeName(import->field_name);
+    std::string args;
+    for (size_t i = 0; i < sig.param_types.size(); ++i)
+      args += ", a" + std::to_string(i);
+
+    stream->Writef("/* import: '%s' '%s' */\n", import->module_name.c_str(),
+                   import->field_name.c_str());
+    stream->Writef("static %s %s(%s) {\n", CResultType(sig).c_str(),
+                   wrapper.c_str(), CParams(sig, true).c_str());
+    if (import->module_name != "env") {
+      stream->Writef("   unsupported(\"unknown import module '%s'\");\n",
+                     import->module_name.c_str());
+    } else if (s_builtins.count(import->field_name)) {
+      stream->Writef("   return builtins::%s(%s);\n",
+                     import->field_name.c_str(),
+                     args.empty() ? "" : args.c_str() + 2);
+    } else if (import->field_name.compare(0, 2, "__") == 0) {
+      // the remaining compiler builtins are the quad precision float ones
+      stream->Writef("   unsupported(\"%s is not supported by eosio-wasm2native\");\n",
+                     import->field_name.c_str());
+    } else {
+      stream->Writef("   return call(&::%s%s);\n", import->field_name.c_str(),
+                     args.c_str());
+    }
+    stream->Writef("}\n");
+    stream->Writef("%s (*%s%s)(%s) = &%s;\n\n", CResultType(sig).c_str(),
+                   MangleName(import->module_name).c_str(),
+                   MangleFuncName(import->field_name, sig).c_str(),
+                   CParams(sig, false).c_str(), wrapper.c_str());
+  }
+
+  const Export* apply = module.GetExport("apply");
+  if (!apply || apply->kind != ExternalKind::Func) {
+    fprintf(stderr, "error: contract doesn't export an `apply` function\n");
+    return Result::Error;
+  }
+  const Func* func = module.GetFunc(apply->var);
+  std::string memory = MemoryExportName(module);
+
+  stream->Writef("extern \"C\" void apply(uint64_t receiver, uint64_t code, uint64_t action) {\n");
+  if (memory.empty()) {
+    stream->Writef("   wasm_rt_call_stack_depth = 0;\n");
+    stream->Writef("   WASM_RT_ADD_PREFIX(init)();\n");
+  } else {
+    stream->Writef("   start_apply(&WASM_RT_ADD_PREFIX(init), &WASM_RT_ADD_PREFIX(%s));\n",
+                   memory.c_str());
+  }
+  stream->Writef("   (*WASM_RT_ADD_PREFIX(%s))(receiver, code, action);\n",
+                 MangleFuncName("apply", func->decl.sig).c_str());
+  stream->Writef("}\n");
+  return result;
+}
+
+int ProgramMain(int argc, char** argv) {
+  Result result;
+
+  InitStdio();
+  ParseOptions(argc, argv);
+
+  std::vector<uint8_t> file_data;
+  result = ReadFile(s_infile.c_str(), &file_data);
+  if (Succeeded(result)) {
+    ErrorHandlerFile error_handler(Location::Type::Binary);
+    Module module;
+    const bool kStopOnFirstError = true;
+    const bool kFailOnCustomSectionError = true;
+    ReadBinaryOptions options(s_features, s_log_stream.get(),
+                              s_read_debug_names, kStopOnFirstError,
+                              kFailOnCustomSectionError);
+    result = ReadBinaryIr(s_infile.c_str(), file_data.data(), file_data.size(),
+                          &options, &error_handler, &module);
+    if (Succeeded(result)) {
+      ExportMemory(&module);
+      ValidateOptions options(s_features);
+      WastLexer* lexer = nullptr;
+      result = ValidateModule(lexer, &module, &error_handler, &options);
+      result |= GenerateNames(&module);
+    }
+
+    if (Succeeded(result)) {
+      Result dummy_result = ApplyNames(&module);
+      WABT_USE(dummy_result);
+    }
+
+    if (Succeeded(result)) {
+      std::string base = StripExtension(s_outfile);
+      std::string header_name = base + ".h";
+      std::string glue_name = base + "_glue.cpp";
+
+      FileStream glue_stream(glue_name);
+      result = WriteGlue(&glue_stream, BaseName(header_name), module);
+
+      if (Succeeded(result)) {
+        FileStream c_stream(s_outfile.c_str());
+        FileStream h_stream(header_name);
+        // prefix the exports so that they don't collide with the native tester
+        h_stream.Writef("#define WASM_RT_MODULE_PREFIX %s_\n",
+                        LegalizeName(BaseName(base)).c_str());
+        result = WriteC(&c_stream, &h_stream, BaseName(header_name).c_str(),
+                        &module, &s_write_c_options);
+      }
+    }
+  }
+  return result != Result::Ok;
+}
+
+int main(int argc, char** argv) {
+  WABT_TRY
+  return ProgramMain(argc, argv);
+  WABT_CATCH_BAD_ALLOC_AND_EXIT
+}
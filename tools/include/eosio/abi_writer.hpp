@@ -0,0 +1,270 @@
+#pragma once
+
+#include <eosio/abi.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eosio { namespace cdt {
+
+   /**
+    * Serializes an `abi` as compact JSON straight into a string.
+    *
+    * The layout and escaping are the same as the jsoncons `ojson` tree abigen used to build,
+    * so the generated ABI doesn't change, but nothing is allocated besides the output.
+    */
+   class abi_json_writer {
+      public:
+         explicit abi_json_writer(std::string& out) : out(out) {}
+
+         void write(const abi& a, const std::string& comment) {
+            out += '{';
+            key("____comment", true);
+            string(comment);
+            key("version");
+            string(a.version);
+            array("structs", a.structs, [&](const abi_struct& s) {
+               out += '{';
+               key("name", true);
+               string(s.name);
+               key("base");
+               string(s.base);
+               array("fields", s.fields, [&](const abi_field& f) {
+                  out += '{';
+                  key("name", true);
+                  string(f.name);
+                  key("type");
+                  string(f.type);
+                  out += '}';
+               });
+               out += '}';
+            });
+            array("types", a.typedefs, [&](const abi_typedef& t) {
+               out += '{';
+               key("new_type_name", true);
+               string(t.new_type_name);
+               key("type");
+               string(t.type);
+               out += '}';
+            });
+            array("actions", a.actions, [&](const abi_action& act) {
+               out += '{';
+               key("name", true);
+               string(act.name);
+               key("type");
+               string(act.type);
+               key("ricardian_contract");
+               string(act.ricardian_contract);
+               out += '}';
+            });
+            array("tables", a.tables, [&](const abi_table& t) {
+               out += '{';
+               key("name", true);
+               string(t.name);
+               key("type");
+               string(t.type);
+               key("index_type");
+               string("i64");
+               array("key_names", t.key_names, [&](const std::string& n) { string(n); });
+               array("key_types", t.key_types, [&](const std::string& n) { string(n); });
+               out += '}';
+            });
+            array("ricardian_clauses", a.ricardian_clauses, [&](const abi_ricardian_clause_pair& rc) {
+               out += '{';
+               key("id", true);
+               string(rc.id);
+               key("body");
+               string(rc.body);
+               out += '}';
+            });
+            array("variants", a.variants, [&](const abi_variant& v) {
+               out += '{';
+               key("name", true);
+               string(v.name);
+               array("types", v.types, [&](const std::string& t) { string(t); });
+               out += '}';
+            });
+            if (!a.error_messages.empty())
+               array("error_messages", a.error_messages, [&](const abi_error_message& e) { error_message(e); });
+            key("abi_extensions");
+            out += "[]";
+            out += '}';
+         }
+
+         /// writes only the error table, `{"error_messages":[...]}`, in the layout of the ABI
+         void write_error_messages(const std::vector<abi_error_message>& errors) {
+            out += '{';
+            array("error_messages", errors, [&](const abi_error_message& e) { error_message(e); }, true);
+            out += '}';
+         }
+
+      private:
+         std::string& out;
+
+         void key(const char* k, bool first=false) {
+            if (!first)
+               out += ',';
+            out += '"';
+            out += k;
+            out += "\":";
+         }
+
+         template <typename Container, typename F>
+         void array(const char* k, const Container& c, F&& f, bool first_key=false) {
+            key(k, first_key);
+            out += '[';
+            bool first = true;
+            for (const auto& e : c) {
+               if (!first)
+                  out += ',';
+               first = false;
+               f(e);
+            }
+            out += ']';
+         }
+
+         void error_message(const abi_error_message& e) {
+            out += '{';
+            key("error_code", true);
+            out += std::to_string(e.error_code);
+            key("error_msg");
+            string(e.error_msg);
+            out += '}';
+         }
+
+         void string(const std::string& s) {
+            static const char hex[] = "0123456789ABCDEF";
+            out.reserve(out.size() + s.size() + 2);
+            out += '"';
+            for (char c : s) {
+               switch (c) {
+                  case '\\': out += "\\\\"; break;
+                  case '"':  out += "\\\""; break;
+                  case '\b': out += "\\b";  break;
+                  case '\f': out += "\\f";  break;
+                  case '\n': out += "\\n";  break;
+                  case '\r': out += "\\r";  break;
+                  case '\t': out += "\\t";  break;
+                  default:
+                     if ((unsigned char)c <= 0x1f || c == 0x7f) {
+                        out += "\\u00";
+                        out += hex[(unsigned char)c >> 4];
+                        out += hex[c & 0xf];
+                     } else {
+                        out += c;
+                     }
+               }
+            }
+            out += '"';
+         }
+   };
+
+   /**
+    * Serializes an `abi` in the packed form of `abi_def` which nodeos stores on chain
+    * (see eosio libraries/chain/include/eosio/chain/abi_def.hpp).
+    */
+   class abi_binary_writer {
+      public:
+         explicit abi_binary_writer(std::vector<char>& out) : out(out) {}
+
+         void write(const abi& a) {
+            string(a.version);
+            varuint(a.typedefs.size());
+            for (const auto& t : a.typedefs) {
+               string(t.new_type_name);
+               string(t.type);
+            }
+            varuint(a.structs.size());
+            for (const auto& s : a.structs) {
+               string(s.name);
+               string(s.base);
+               varuint(s.fields.size());
+               for (const auto& f : s.fields) {
+                  string(f.name);
+                  string(f.type);
+               }
+            }
+            varuint(a.actions.size());
+            for (const auto& act : a.actions) {
+               name(act.name);
+               string(act.type);
+               string(act.ricardian_contract);
+            }
+            varuint(a.tables.size());
+            for (const auto& t : a.tables) {
+               name(t.name);
+               string("i64");
+               strings(t.key_names);
+               strings(t.key_types);
+               string(t.type);
+            }
+            varuint(a.ricardian_clauses.size());
+            for (const auto& rc : a.ricardian_clauses) {
+               string(rc.id);
+               string(rc.body);
+            }
+            varuint(a.error_messages.size());
+            for (const auto& e : a.error_messages) {
+               uint64(e.error_code);
+               string(e.error_msg);
+            }
+            // abi_extensions
+            varuint(0);
+            // variants are a binary_extension of abi_def
+            varuint(a.variants.size());
+            for (const auto& v : a.variants) {
+               string(v.name);
+               strings(v.types);
+            }
+         }
+
+      private:
+         std::vector<char>& out;
+
+         void varuint(uint64_t v) {
+            do {
+               uint8_t b = v & 0x7f;
+               v >>= 7;
+               out.push_back(b | (v ? 0x80 : 0));
+            } while (v);
+         }
+
+         void uint64(uint64_t v) {
+            for (int i=0; i < 8; i++)
+               out.push_back(char(v >> (i*8)));
+         }
+
+         void string(const std::string& s) {
+            varuint(s.size());
+            out.insert(out.end(), s.begin(), s.end());
+         }
+
+         void strings(const std::vector<std::string>& v) {
+            varuint(v.size());
+            for (const auto& s : v)
+               string(s);
+         }
+
+         static uint64_t char_to_value(char c) {
+            if (c >= 'a' && c <= 'z')
+               return (c - 'a') + 6;
+            if (c >= '1' && c <= '5')
+               return (c - '1') + 1;
+            return 0;
+         }
+
+         // same encoding as eosio::name
+         void name(const std::string& n) {
+            uint64_t value = 0;
+            for (size_t i=0; i < n.size() && i < 13; i++) {
+               if (i < 12)
+                  value |= (char_to_value(n[i]) & 0x1f) << (64 - 5 * (i + 1));
+               else
+                  value |= char_to_value(n[i]) & 0x0f;
+            }
+            uint64(value);
+         }
+   };
+
+}} // ns eosio::cdt
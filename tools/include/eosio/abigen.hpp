@@ -4,6 +4,7 @@
 #include <eosio/utils.hpp>
 #include <eosio/whereami/whereami.hpp>
 #include <eosio/abi.hpp>
+#include <eosio/abi_writer.hpp>
 
 #include <exception>
 #include <iostream>
@@ -13,13 +14,9 @@
 #include <set>
 #include <map>
 
-#include <jsoncons/json.hpp>
-
 using namespace llvm;
 using namespace eosio;
 using namespace eosio::cdt;
-using jsoncons::json;
-using jsoncons::ojson;
 
 namespace eosio { namespace cdt {
    struct abigen_exception : public std::exception {
@@ -230,6 +227,20 @@ namespace eosio { namespace cdt {
          }
       }
 
+      void add_error_message( const std::string& msg ) {
+         uint64_t code = get_error_code(msg);
+         for ( const auto& e : _abi.error_messages ) {
+            if ( e.error_code == code ) {
+               if ( e.error_msg != msg ) {
+                  std::cout << "Error, messages \"" << e.error_msg << "\" and \"" << msg << "\" have the same error code\n";
+                  error_handler();
+               }
+               return;
+            }
+         }
+         _abi.error_messages.push_back({code, msg});
+      }
+
       void add_contracts( const std::map<std::string, std::string>& rc ) {
          rcs = rc;
       }
@@ -280,62 +291,6 @@ namespace eosio { namespace cdt {
          return ss.str(); 
       }
 
-      ojson struct_to_json( const abi_struct& s ) {
-         ojson o;
-         o["name"] = s.name;
-         o["base"] = s.base;
-         o["fields"] = ojson::array();
-         for ( auto field : s.fields ) {
-            ojson f;
-            f["name"] = field.name;
-            f["type"] = field.type;
-            o["fields"].push_back(f);
-         }
-         return o;
-      }
-
-      ojson variant_to_json( const abi_variant& v ) {
-         ojson o;
-         o["name"] = v.name;
-         o["types"] = ojson::array();
-         for ( auto ty : v.types ) {
-            o["types"].push_back( ty );
-         }
-         return o;
-      }
-
-      ojson typedef_to_json( const abi_typedef& t ) {
-         ojson o;
-         o["new_type_name"] = t.new_type_name;
-         o["type"]          = t.type;
-         return o;
-      }
-
-      ojson action_to_json( const abi_action& a ) {
-         ojson o;
-         o["name"] = a.name;
-         o["type"] = a.type;
-         o["ricardian_contract"] = a.ricardian_contract;
-         return o;
-      }
-
-      ojson clause_to_json( const abi_ricardian_clause_pair& clause ) {
-         ojson o;
-         o["id"] = clause.id;
-         o["body"] = clause.body;
-         return o;
-      }
-
-      ojson table_to_json( const abi_table& t ) {
-         ojson o;
-         o["name"] = t.name;
-         o["type"] = t.type;
-         o["index_type"] = "i64";
-         o["key_names"] = ojson::array();
-         o["key_types"] = ojson::array();
-         return o;
-      }
-      
       bool is_empty() {
          std::set<abi_table> set_of_tables;
          for ( auto t : ctables ) {
@@ -354,14 +309,17 @@ namespace eosio { namespace cdt {
             set_of_tables.insert(t);
          }
 
-         return _abi.structs.empty() && _abi.typedefs.empty() && _abi.actions.empty() && set_of_tables.empty() && _abi.ricardian_clauses.empty() && _abi.variants.empty();
+         return _abi.structs.empty() && _abi.typedefs.empty() && _abi.actions.empty() && set_of_tables.empty() && _abi.ricardian_clauses.empty() && _abi.variants.empty() && _abi.error_messages.empty();
       }
 
-      ojson to_json() {
-         ojson o;
-         o["____comment"] = generate_json_comment();
-         o["version"]     = _abi.version;
-         o["structs"]     = ojson::array();
+      /// the ABI which is written out, only the structs and types reachable from actions and tables
+      abi get_abi() {
+         abi ret;
+         ret.version           = _abi.version;
+         ret.actions           = _abi.actions;
+         ret.ricardian_clauses = _abi.ricardian_clauses;
+         ret.variants          = _abi.variants;
+         ret.error_messages    = _abi.error_messages;
          auto remove_suffix = [&]( std::string name ) {
             int i = name.length()-1;
             for (; i >= 0; i--) 
@@ -383,28 +341,28 @@ namespace eosio { namespace cdt {
             if (!has_multi_index)
                set_of_tables.insert(t);
          }
-         for ( auto t : _abi.tables ) {
+         for ( const auto& t : _abi.tables ) {
             set_of_tables.insert(t);
          }
 
          std::function<std::string(const std::string&)> get_root_name;
          get_root_name = [&] (const std::string& name) {
-            for (auto td : _abi.typedefs)
+            for (const auto& td : _abi.typedefs)
                if (remove_suffix(name) == td.new_type_name)
                   return get_root_name(td.type);
             return name;
          };
 
-         auto validate_struct = [&]( abi_struct as ) {
+         auto validate_struct = [&]( const abi_struct& as ) {
             if ( is_builtin_type(_translate_type(as.name)) )
                return false;
-            for ( auto s : _abi.structs ) {
-               for ( auto f : s.fields ) {
+            for ( const auto& s : _abi.structs ) {
+               for ( const auto& f : s.fields ) {
                   if (as.name == _translate_type(remove_suffix(f.type)))
                      return true;
                }
-               for ( auto v : _abi.variants ) {
-                  for ( auto vt : v.types ) {
+               for ( const auto& v : _abi.variants ) {
+                  for ( const auto& vt : v.types ) {
                      if (as.name == _translate_type(remove_suffix(vt)))
                         return true;
                   }
@@ -412,78 +370,85 @@ namespace eosio { namespace cdt {
                if (get_root_name(s.base) == as.name)
                   return true;
             }
-            for ( auto a : _abi.actions ) {
+            for ( const auto& a : _abi.actions ) {
                if (as.name == _translate_type(a.type))
                   return true;
             }
-            for( auto t : set_of_tables ) {
+            for( const auto& t : set_of_tables ) {
                if (as.name == _translate_type(t.type))
                   return true;
             }
-            for( auto td : _abi.typedefs ) {
+            for( const auto& td : _abi.typedefs ) {
                if (as.name == _translate_type(remove_suffix(td.type)))
                   return true;
             }
             return false;
          };
 
-         auto validate_types = [&]( abi_typedef td ) {
-            for ( auto as : _abi.structs )
+         auto validate_types = [&]( const abi_typedef& td ) {
+            for ( const auto& as : _abi.structs )
                if (validate_struct(as)) {
-                  for ( auto f : as.fields )
+                  for ( const auto& f : as.fields )
                      if ( remove_suffix(f.type) == td.new_type_name )
                         return true;
                   if (as.base == td.new_type_name)
                      return true;
                }
 
-            for ( auto v : _abi.variants ) {
-               for ( auto vt : v.types ) {
+            for ( const auto& v : _abi.variants ) {
+               for ( const auto& vt : v.types ) {
                   if ( remove_suffix(vt) == td.new_type_name )
                      return true;
                }
             }
-            for ( auto t : _abi.tables )
+            for ( const auto& t : _abi.tables )
                if ( t.type == td.new_type_name )
                   return true;
-            for ( auto a : _abi.actions )
+            for ( const auto& a : _abi.actions )
                if ( a.type == td.new_type_name )
                   return true;
-            for ( auto _td : _abi.typedefs )
+            for ( const auto& _td : _abi.typedefs )
                if ( remove_suffix(_td.type) == td.new_type_name )
                   return true;
             return false;
          };
 
-         for ( auto s : _abi.structs ) {
+         for ( const auto& s : _abi.structs ) {
             if (validate_struct(s))
-               o["structs"].push_back(struct_to_json(s));
+               ret.structs.insert(ret.structs.end(), s);
          }
-         o["types"]       = ojson::array();
-         for ( auto t : _abi.typedefs ) {
+         for ( const auto& t : _abi.typedefs ) {
             if (validate_types(t))
-               o["types"].push_back(typedef_to_json( t ));
-         }
-         o["actions"]     = ojson::array();
-         for ( auto a : _abi.actions ) {
-            o["actions"].push_back(action_to_json( a ));
+               ret.typedefs.insert(ret.typedefs.end(), t);
          }
-         o["tables"]     = ojson::array();
-         for ( auto t : set_of_tables ) {
-            o["tables"].push_back(table_to_json( t ));
-         }
-         o["ricardian_clauses"]  = ojson::array();
-         for ( auto rc : _abi.ricardian_clauses ) {
-            o["ricardian_clauses"].push_back(clause_to_json( rc ));
-         }
-         o["variants"]   = ojson::array();
-         for ( auto v : _abi.variants ) {
-            o["variants"].push_back(variant_to_json( v ));
-         }
-         o["abi_extensions"]     = ojson::array();
-         return o;
+         ret.tables = std::move(set_of_tables);
+         return ret;
+      }
+
+      std::string to_json() {
+         std::string ret;
+         abi_json_writer(ret).write(get_abi(), generate_json_comment());
+         return ret;
+      }
+
+      std::vector<char> to_binary() {
+         std::vector<char> ret;
+         abi_binary_writer(ret).write(get_abi());
+         return ret;
+      }
+
+      bool has_error_messages()const {
+         return !_abi.error_messages.empty();
+      }
+
+      /// the error table of every file compiled so far, written next to the wasm by -error-codes
+      std::string error_messages_to_json() {
+         std::string ret;
+         abi_json_writer(ret).write_error_messages(_abi.error_messages);
+         return ret;
       }
 
+
       private: 
          abi                                   _abi;
          std::set<const clang::CXXRecordDecl*> tables;
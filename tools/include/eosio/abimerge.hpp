@@ -33,6 +33,8 @@ class ABIMerger {
          ret["tables"]   = merge_tables(other);
          ret["ricardian_clauses"]  = merge_clauses(other);
          ret["variants"] = merge_variants(other);
+         if (abi.has_key("error_messages") || other.has_key("error_messages"))
+            ret["error_messages"] = merge_error_messages(other);
          return ret;
       }
    private:
@@ -104,6 +106,11 @@ class ABIMerger {
          return a["id"] == b["id"] &&
                 a["body"] == b["body"];
       } 
+
+      static bool error_message_is_same(ojson a, ojson b) {
+         return a["error_code"] == b["error_code"] &&
+                a["error_msg"] == b["error_msg"];
+      }
          
       template <typename F> 
       void add_object(ojson& ret, ojson a, ojson b, std::string type, std::string id, F&& is_same_func) {
@@ -162,6 +169,18 @@ class ABIMerger {
          return cls;
       }
 
+      ojson merge_error_messages(ojson b) {
+         // only ABIs of contracts built with -error-codes have error messages
+         ojson a = abi;
+         if (!a.has_key("error_messages"))
+            a["error_messages"] = ojson::array();
+         if (!b.has_key("error_messages"))
+            b["error_messages"] = ojson::array();
+         ojson errs = ojson::array();
+         add_object(errs, a, b, "error_messages", "error_code", error_message_is_same);
+         return errs;
+      }
+
       ojson abi;
 };
 #pragma GCC diagnostic pop
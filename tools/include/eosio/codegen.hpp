@@ -43,13 +43,14 @@ using namespace eosio::cdt;
 namespace eosio { namespace cdt {
    // replace with std::quoted and std::make_unique when we can get better C++14 support for Centos
    std::string _quoted(const std::string& instr) {
-      std::stringstream ss;
+      std::string ret;
+      ret.reserve(instr.size());
       for (char c : instr) {
          if (c == '"' || c == '\\')
-            ss << '\\';
-         ss << c;
+            ret += '\\';
+         ret += c;
       }
-      return ss.str();
+      return ret;
    }
    template<typename T, typename... Args>
    std::unique_ptr<T> _make_unique(Args&&... args) {
@@ -87,6 +88,7 @@ namespace eosio { namespace cdt {
          llvm::ArrayRef<std::string>           sources;
          size_t                                source_index = 0;
          std::map<std::string, std::string>    tmp_files;
+         bool                                  error_codes = false;
 
          codegen() : generation_utils([&](){throw codegen_ex;}) {
          }
@@ -101,7 +103,11 @@ namespace eosio { namespace cdt {
          }
 
          void set_abi(std::string s) {
-            abi = s;
+            abi = std::move(s);
+         }
+
+         void set_error_codes(bool b) {
+            error_codes = b;
          }
    };
 
@@ -154,6 +160,7 @@ namespace eosio { namespace cdt {
       public:
          std::vector<CXXMethodDecl*> action_decls;
          std::vector<CXXMethodDecl*> notify_decls;
+         size_t                      replaced_check_messages = 0;
 
          explicit eosio_codegen_visitor(CompilerInstance *CI)
                : generation_utils([&](){throw cg.codegen_ex;}), ci(CI) {
@@ -192,6 +199,13 @@ namespace eosio { namespace cdt {
             inst.getDiagnostics().Report(full, id);
          }
 
+         template <size_t N>
+         void emitWarning(CompilerInstance& inst, SourceLocation loc, const char (&warning)[N]) {
+            FullSourceLoc full(loc, inst.getSourceManager());
+            unsigned id = inst.getDiagnostics().getCustomDiagID(clang::DiagnosticsEngine::Warning, warning);
+            inst.getDiagnostics().Report(full, id);
+         }
+
          std::string get_base_type(const QualType& qt) {
             std::istringstream ss(qt.getAsString());
             std::vector<std::string> results((std::istream_iterator<std::string>(ss)),
@@ -271,7 +285,10 @@ namespace eosio { namespace cdt {
                   if (i < decl->parameters().size()-1)
                      ss << ", ";
                }
-               ss << ");";
+               ss << ");\n";
+               ss << "#ifdef EOSIO_PRINT_BUFFER\n";
+               ss << "eosio::print_buffer::flush();\n";
+               ss << "#endif\n";
                ss << "}}\n";
 
                rewriter.InsertTextAfter(ci->getSourceManager().getLocForEndOfFile(main_fid), ss.str());
@@ -343,6 +360,35 @@ namespace eosio { namespace cdt {
             return true;
          }
 
+         virtual bool VisitCallExpr(CallExpr* expr) {
+            auto callee = expr->getDirectCallee();
+            if (!callee || callee->getQualifiedNameAsString() != "eosio::check")
+               return true;
+            auto& sm = ci->getSourceManager();
+            // with -error-codes the message is replaced by its code, which abigen put in the error_messages of the ABI
+            if (cg.error_codes) {
+               if (auto msg = get_check_message(expr, sm)) {
+                  rewriter.ReplaceText(msg->getSourceRange(), std::to_string(get_error_code(msg->getString()))+"ull");
+                  replaced_check_messages++;
+                  return true;
+               }
+            }
+            // eosio::check(pred, std::string(...)) builds the message even when the check passes
+            if (!sm.isWrittenInMainFile(sm.getExpansionLoc(expr->getExprLoc())))
+               return true;
+            for (unsigned i=1; i < expr->getNumArgs(); i++) {
+               auto arg = expr->getArg(i)->IgnoreImplicit();
+               if (!arg->isRValue())
+                  continue;
+               if (auto rd = arg->getType()->getAsCXXRecordDecl()) {
+                  if (rd->getName() == "basic_string" && rd->isInStdNamespace())
+                     emitWarning(*ci, arg->getExprLoc(), "std::string temporary is built for the message of check() even when it passes, "
+                                                         "use check_f(pred, \"message with %% placeholders\", args...) to only format it on failure");
+               }
+            }
+            return true;
+         }
+
          /*
          virtual bool VisitRecordDecl(RecordDecl* decl) {
             static std::set<std::string> _action_set; //used for validations
@@ -399,7 +445,8 @@ namespace eosio { namespace cdt {
                for (auto nd : visitor->notify_decls)
                   visitor->create_notify_dispatch(nd);
 
-               if (cg.actions.size() < 1 && cg.notify_handlers.size() < 1) {
+               bool has_dispatch = cg.actions.size() > 0 || cg.notify_handlers.size() > 0;
+               if (!has_dispatch && visitor->replaced_check_messages == 0) {
                   return;
                }
 
@@ -414,19 +461,21 @@ namespace eosio { namespace cdt {
                      visitor->get_rewriter().ReplaceText(inc.range,
                            std::string("\"")+inc.file_name+"\"\n");
                   }
-                  // generate apply stub with abi
-                  std::stringstream ss;
-                  ss << "extern \"C\" {\n";
-                  ss << "void eosio_assert_code(uint32_t, uint64_t);";
-                  ss << "\t__attribute__((weak, eosio_wasm_entry, eosio_wasm_abi(";
-                  std::string abi = cg.abi;
-                  ss << "\"" << _quoted(abi) << "\"";
-                  ss << ")))\n";
-                  ss << "\tvoid __insert_eosio_abi(unsigned long long r, unsigned long long c, unsigned long long a){";
-                  ss << "eosio_assert_code(false, 1);";
-                  ss << "}\n";
-                  ss << "}";
-                  visitor->get_rewriter().InsertTextAfter(ci->getSourceManager().getLocForEndOfFile(fid), ss.str());
+                  // generate apply stub with abi, files with rewritten checks carry it too so the linker merges
+                  // the error table of every file whatever order they were compiled in
+                  if ((has_dispatch || visitor->replaced_check_messages > 0) && !cg.abi.empty()) {
+                     std::stringstream ss;
+                     ss << "extern \"C\" {\n";
+                     ss << "void eosio_assert_code(uint32_t, uint64_t);";
+                     ss << "\t__attribute__((weak, eosio_wasm_entry, eosio_wasm_abi(";
+                     ss << "\"" << _quoted(cg.abi) << "\"";
+                     ss << ")))\n";
+                     ss << "\tvoid __insert_eosio_abi(unsigned long long r, unsigned long long c, unsigned long long a){";
+                     ss << "eosio_assert_code(false, 1);";
+                     ss << "}\n";
+                     ss << "}";
+                     visitor->get_rewriter().InsertTextAfter(ci->getSourceManager().getLocForEndOfFile(fid), ss.str());
+                  }
                   auto& RewriteBuf = visitor->get_rewriter().getEditBuffer(fid);
                   out << std::string(RewriteBuf.begin(), RewriteBuf.end());
                   cg.tmp_files.emplace(main_file, fn.str());
@@ -3,6 +3,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/Expr.h"
 #include "clang/Basic/Builtins.h"
+#include "clang/Basic/SourceManager.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/raw_ostream.h"
@@ -193,6 +194,33 @@ struct generation_utils {
          return tmp;
       return decl->getName();
    }
+
+   /**
+    * The message of an `eosio::check(pred, "message")` call of the main file, or nullptr for any other
+    * call. With -error-codes eosio-cpp replaces these messages with `get_error_code(message)`.
+    */
+   static inline const clang::StringLiteral* get_check_message( const clang::CallExpr* call, const clang::SourceManager& sm ) {
+      auto callee = call->getDirectCallee();
+      if (!callee || call->getNumArgs() != 2 || callee->getQualifiedNameAsString() != "eosio::check")
+         return nullptr;
+      auto msg = llvm::dyn_cast<clang::StringLiteral>(call->getArg(1)->IgnoreParenImpCasts());
+      // literals expanded from macros can't be rewritten
+      if (!msg || msg->getCharByteWidth() != 1 || !msg->getExprLoc().isFileID() || !sm.isInMainFile(msg->getExprLoc()))
+         return nullptr;
+      return msg;
+   }
+
+   // FNV-1a of the message, so the code of a message doesn't change when others are added, reduced
+   // to 18 digits to stay clear of the error codes reserved by the system
+   static inline uint64_t get_error_code( llvm::StringRef msg ) {
+      uint64_t h = 0xcbf29ce484222325ull;
+      for (char c : msg) {
+         h ^= (unsigned char)c;
+         h *= 0x100000001b3ull;
+      }
+      return h % 1000000000000000000ull;
+   }
+
    inline std::string get_rc_filename() {
       return contract_name+".contracts.md";
    }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "llvm/Support/FileSystem.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace cdt {
+   /**
+    * Writer for Chrome trace-event files (chrome://tracing, ui.perfetto.dev).
+    *
+    * Events are appended in the JSON array format, where the closing bracket is optional,
+    * so that eosio-cpp, eosio-ld and eosio-pp can each append their own events to the same file.
+    */
+   class time_trace {
+      public:
+         static time_trace& get() {
+            static time_trace inst;
+            return inst;
+         }
+
+         /// the process that owns the build truncates the file, sub-tools only append to it
+         void set_file(const std::string& fn, bool truncate) {
+            file_name = fn;
+            if (truncate || !llvm::sys::fs::exists(file_name)) {
+               std::ofstream out(file_name, std::ios::trunc);
+               out << "[\n";
+            }
+         }
+
+         bool enabled()const { return !file_name.empty(); }
+         const std::string& get_file()const { return file_name; }
+
+         static uint64_t now() {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count();
+         }
+
+         /// peak resident set size in KiB, `who` is RUSAGE_SELF or RUSAGE_CHILDREN
+         static uint64_t peak_rss_kb(int who) {
+            struct rusage ru;
+            if (getrusage(who, &ru) != 0)
+               return 0;
+#ifdef __APPLE__
+            return ru.ru_maxrss / 1024;
+#else
+            return ru.ru_maxrss;
+#endif
+         }
+
+         static uint64_t file_size(const std::string& fn) {
+            uint64_t size = 0;
+            if (llvm::sys::fs::file_size(fn, size))
+               return 0;
+            return size;
+         }
+
+         void add_event(const std::string& name, const std::string& cat, uint64_t start, uint64_t dur,
+                        const std::vector<std::pair<std::string, std::string>>& args) {
+            if (!enabled())
+               return;
+            std::stringstream ss;
+            ss << "{\"name\":\"" << escape(name) << "\",\"cat\":\"" << escape(cat) << "\",\"ph\":\"X\""
+               << ",\"ts\":" << start << ",\"dur\":" << dur << ",\"pid\":" << getpid() << ",\"tid\":0"
+               << ",\"args\":{";
+            for (size_t i=0; i < args.size(); i++) {
+               ss << "\"" << escape(args[i].first) << "\":" << args[i].second;
+               if (i < args.size()-1)
+                  ss << ",";
+            }
+            ss << "}},\n";
+            std::ofstream out(file_name, std::ios::app);
+            out << ss.str();
+         }
+
+         // escapes the quotes, backslashes and control characters, which JSON strings can't contain as is
+         static std::string escape(const std::string& s) {
+            static constexpr char hex[] = "0123456789abcdef";
+            std::string ret;
+            for (char c : s) {
+               unsigned char u = static_cast<unsigned char>(c);
+               if (c == '"' || c == '\\') {
+                  ret += '\\';
+                  ret += c;
+               } else if (u < 0x20) {
+                  ret += "\\u00";
+                  ret += hex[u >> 4];
+                  ret += hex[u & 0xf];
+               } else {
+                  ret += c;
+               }
+            }
+            return ret;
+         }
+
+      private:
+         std::string file_name;
+   };
+
+   /**
+    * Times the enclosing scope and emits one complete ("X") event when destroyed.
+    */
+   class time_trace_scope {
+      public:
+         time_trace_scope(std::string name, std::string cat)
+            : name(std::move(name)), cat(std::move(cat)), start(time_trace::now()) {}
+
+         ~time_trace_scope() {
+            time_trace::get().add_event(name, cat, start, time_trace::now()-start, args);
+         }
+
+         void add_arg(const std::string& key, const std::string& value) {
+            args.emplace_back(key, "\""+time_trace::escape(value)+"\"");
+         }
+
+         void add_arg(const std::string& key, uint64_t value) {
+            args.emplace_back(key, std::to_string(value));
+         }
+
+      private:
+         std::string name;
+         std::string cat;
+         uint64_t    start;
+         std::vector<std::pair<std::string, std::string>> args;
+   };
+}} // ns eosio::cdt
@@ -45,6 +45,12 @@ class Test(ABC):
         cf = self.test_json.get("compile_flags")
         args = cf if cf else []
 
+        # other source files of the contract, next to the test file
+        extra = self.test_json.get("extra_sources")
+        if extra:
+            directory = os.path.dirname(self.cpp_file)
+            args = [os.path.join(directory, f) for f in extra] + args
+
         eosio_cpp = os.path.join(Config.cdt_path, "eosio-cpp")
         self._run(eosio_cpp, args)
 
@@ -97,6 +103,17 @@ class Test(ABC):
                     failing_test=self,
                 )
 
+        if expected.get("stdout"):
+            expected_stdout = expected["stdout"]
+            actual_stdout = res.stdout.decode("utf-8")
+
+            if expected_stdout not in actual_stdout:
+                self.success = False
+                raise TestFailure(
+                    f"expected {expected_stdout} stdout but got {actual_stdout}",
+                    failing_test=self,
+                )
+
         if expected.get("abi"):
             expected_abi = expected["abi"]
             with open(f"{self._name}.abi") as f:
@@ -116,6 +133,27 @@ class Test(ABC):
                         "actual abi did not match expected abi", failing_test=self
                     )
 
+        if expected.get("error_messages"):
+            # the error table written by -error-codes, both next to the wasm and in the abi
+            expected_errors = sorted(
+                (e["error_code"], e["error_msg"]) for e in expected["error_messages"]
+            )
+            for file_name, section in (
+                (f"{self._name}.errors.json", "error table"),
+                (f"{self._name}.abi", "abi"),
+            ):
+                with open(file_name) as f:
+                    actual_errors = sorted(
+                        (e["error_code"], e["error_msg"])
+                        for e in json.load(f).get("error_messages", [])
+                    )
+                if expected_errors != actual_errors:
+                    self.success = False
+                    raise TestFailure(
+                        f"error messages of the {section} did not match, got {actual_errors}",
+                        failing_test=self,
+                    )
+
         if expected.get("wasm"):
             expected_wasm = expected["wasm"]
 